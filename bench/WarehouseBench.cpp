@@ -0,0 +1,425 @@
+#include "../include/WareHouse.h"
+#include "../include/WarehouseEngine.h"
+#include "../include/Action.h"
+#include "../include/WorkloadGenerator.h"
+
+#include <iostream>
+#include <fstream>
+#include <sstream>
+#include <chrono>
+#include <cstdio>
+#include <cstdlib>
+#include <thread>
+#include <atomic>
+#ifdef __GLIBC__
+#include <malloc.h>
+#endif
+
+using namespace std;
+
+/**
+ * Swallows everything the actions print, so the benchmark measures the engine and not the terminal.
+ */
+class NullBuffer : public std::streambuf {
+    protected:
+        int overflow(int c) override { return c; }
+        std::streamsize xsputn(const char *, std::streamsize n) override { return n; }
+};
+
+typedef std::chrono::steady_clock Clock;
+
+static double secondsSince(Clock::time_point start) {
+    return std::chrono::duration<double>(Clock::now() - start).count();
+}
+
+struct BenchOptions {
+    vector<long> scales;
+    unsigned long long seed;
+    ArrivalPattern pattern;
+    int queries;
+    string out;
+    string workdir;
+    string emit;
+    bool views; // Publish read views and query them from another thread while the script runs
+    vector<DispatchPolicy> dispatch;
+    int drivers; // Overrides the generated amount of drivers, 0 keeps it
+    int capacity; // Orders each driver carries per trip
+    int collectors; // Overrides the generated amount of collectors, 0 keeps it
+    int batch; // Orders each collector picks per cycle
+    bool journal; // Compare replaying the script from a journal with feeding it as text
+    ServiceDistribution service; // Service times of the generated volunteers
+
+    BenchOptions() : scales({1000, 10000, 100000}), seed(42), pattern(ArrivalPattern::Uniform), queries(100),
+                     out(), workdir("."), emit(), views(false), dispatch({DispatchPolicy::Greedy}), drivers(0),
+                     capacity(1), collectors(0), batch(1), journal(false),
+                     service(ServiceDistribution::Fixed) { }
+};
+
+static void usage() {
+    std::cerr << "usage: warehouse_bench [--scales 1000,10000,...] [--seed <s>] [--pattern uniform|burst|poisson]\n"
+                 "                       [--queries <n>] [--out <csv>] [--workdir <dir>] [--emit <prefix>]\n"
+                 "                       [--views on|off] [--dispatch greedy|matching|both] [--drivers <n>]\n"
+                 "                       [--capacity <orders per trip>] [--collectors <n>] [--batch <orders per cycle>]\n"
+                 "                       [--journal on|off] [--service fixed|uniform|exponential]\n";
+}
+
+static bool parseOptions(int argc, char **argv, BenchOptions &options) {
+    for (int i = 1; i < argc; i++) {
+        string arg = argv[i];
+        if (i + 1 >= argc) return false;
+        string value = argv[++i];
+        if (arg == "--scales") {
+            options.scales.clear();
+            std::stringstream ss(value);
+            string item;
+            while (getline(ss, item, ',')) options.scales.push_back((long) std::atof(item.c_str()));
+        }
+        else if (arg == "--seed") options.seed = std::strtoull(value.c_str(), nullptr, 10);
+        else if (arg == "--pattern") {
+            if (!WorkloadGenerator::parsePattern(value, options.pattern)) return false;
+        }
+        else if (arg == "--queries") options.queries = std::atoi(value.c_str());
+        else if (arg == "--out") options.out = value;
+        else if (arg == "--workdir") options.workdir = value;
+        else if (arg == "--emit") options.emit = value;
+        else if (arg == "--views") options.views = value == "on";
+        else if (arg == "--journal") options.journal = value == "on";
+        else if (arg == "--service") {
+            if (!ServiceTime::parseDistribution(value, options.service)) return false;
+        }
+        else if (arg == "--drivers") options.drivers = std::atoi(value.c_str());
+        else if (arg == "--capacity") options.capacity = std::atoi(value.c_str());
+        else if (arg == "--collectors") options.collectors = std::atoi(value.c_str());
+        else if (arg == "--batch") options.batch = std::atoi(value.c_str());
+        else if (arg == "--dispatch") {
+            options.dispatch.clear();
+            if (value == "greedy" || value == "both") options.dispatch.push_back(DispatchPolicy::Greedy);
+            if (value == "matching" || value == "both") options.dispatch.push_back(DispatchPolicy::Matching);
+            if (options.dispatch.empty()) return false;
+        }
+        else return false;
+    }
+    return !options.scales.empty();
+}
+
+struct Run {
+    long scale;
+    string pattern;
+    string dispatch;
+};
+
+static void writeRow(std::ostream &csv, const Run &run, const string &phase, long operations, double seconds,
+                     double completedPerStep = -1, double bytesPerOrder = -1) {
+    csv << run.scale << "," << run.pattern << "," << run.dispatch << "," << phase << "," << operations << ","
+        << seconds << "," << (seconds > 0 ? operations / seconds : 0) << ",";
+    if (completedPerStep >= 0) csv << completedPerStep;
+    csv << ",";
+    if (bytesPerOrder >= 0) csv << bytesPerOrder;
+    csv << std::endl;
+}
+
+/**
+ * @returns bytes currently allocated on the heap, including the large blocks the allocator mmaps on their own
+ * (e.g. the order pool's chunks), -1 if the allocator can't tell.
+ */
+static long heapInUse() {
+#ifdef __GLIBC__
+    struct mallinfo2 info = mallinfo2();
+    return (long) (info.uordblks + info.hblkhd);
+#else
+    return -1;
+#endif
+}
+
+/**
+ * Compares storing orders one per heap allocation behind a pointer (how orders used to be stored) with the
+ * OrderPool: bytes per order, and the time it takes to snapshot all of them (what backup does).
+ */
+static void measureOrderMemory(const Run &run, long count, std::ostream &csv) {
+    long before = heapInUse();
+    vector<Order*> heapOrders;
+    heapOrders.reserve(count);
+    for (long i = 0; i < count; i++) heapOrders.push_back(new Order((int) i, (int) (i % 1000), 1 + (int) (i % 10)));
+    long heapBytes = heapInUse() - before;
+    Clock::time_point start = Clock::now();
+    vector<Order*> heapCopy;
+    heapCopy.reserve(count);
+    for (const Order *order : heapOrders) heapCopy.push_back(new Order(*order));
+    writeRow(csv, run, "orders_heap", count, secondsSince(start), -1, before < 0 ? -1 : (double) heapBytes / count);
+    for (Order *order : heapCopy) delete order;
+    for (Order *order : heapOrders) delete order;
+
+    before = heapInUse();
+    OrderPool pool;
+    for (long i = 0; i < count; i++) pool.add(Order((int) i, (int) (i % 1000), 1 + (int) (i % 10)));
+    long poolBytes = heapInUse() - before;
+    start = Clock::now();
+    OrderPool poolCopy(pool);
+    writeRow(csv, run, "orders_pool", count, secondsSince(start), -1, before < 0 ? -1 : (double) poolBytes / count);
+}
+
+/**
+ * Writes the command script to a journal, then restores a warehouse from it and another one by feeding it the
+ * script's text, as a crashed session would be restored with and without the journal.
+ */
+static void measureJournal(const Run &run, const string &configPath, const string &commandsPath,
+                           const string &journalPath, std::ostream &csv) {
+    vector<string> lines;
+    {
+        std::ifstream commands(commandsPath);
+        string line;
+        while (getline(commands, line)) lines.push_back(line);
+    }
+    std::remove(journalPath.c_str());
+    Clock::time_point start = Clock::now();
+    unsigned long syncs;
+    {
+        Journal journal(journalPath);
+        for (const string &line : lines) journal.append(line);
+        journal.flush();
+        syncs = journal.getSyncs();
+    }
+    double seconds = secondsSince(start);
+    writeRow(csv, run, "journal_append", lines.size(), seconds);
+    writeRow(csv, run, "journal_fsync", syncs, seconds); // Group commit, one fsync covers many commands
+
+    {
+        WareHouse wareHouse(configPath);
+        start = Clock::now();
+        long replayed = Journal::replay(journalPath, wareHouse);
+        writeRow(csv, run, "journal_replay", replayed, secondsSince(start));
+    }
+    {
+        WareHouse wareHouse(configPath);
+        start = Clock::now();
+        for (const string &line : lines) wareHouse.execute(line);
+        writeRow(csv, run, "text_replay", lines.size(), secondsSince(start));
+    }
+    std::remove(journalPath.c_str());
+}
+
+#define SUBMIT_PRODUCERS 4
+#define SUBMIT_CUSTOMERS 1000
+
+/**
+ * Submits orders from SUBMIT_PRODUCERS threads while the simulation thread keeps stepping, then checks the ids:
+ * every submitted order was placed once, and each producer's orders got increasing ids in the order it submitted
+ * them (the queue drains each producer's submissions in order). Producer p orders for the customers p,
+ * p + SUBMIT_PRODUCERS, ... in turn, so an order's customer tells which producer submitted it.
+ * @returns false if the ids don't match the submissions, after printing the first mismatch.
+ */
+static bool measureSubmit(const Run &run, long count, std::ostream &csv) {
+    WarehouseEngine engine;
+    long perProducer = count / SUBMIT_PRODUCERS;
+    int maxOrders = (int) (perProducer * SUBMIT_PRODUCERS / SUBMIT_CUSTOMERS + 1);
+    for (int i = 0; i < SUBMIT_CUSTOMERS; i++) {
+        engine.addCustomer("c" + std::to_string(i), CustomerType::Civilian, 1, maxOrders);
+    }
+    for (int i = 0; i < SUBMIT_CUSTOMERS / 10; i++) {
+        engine.addCollector("collector" + std::to_string(i), 1);
+        engine.addDriver("driver" + std::to_string(i), 1, 1);
+    }
+
+    std::atomic<int> producing(SUBMIT_PRODUCERS);
+    vector<std::thread> producers;
+    Clock::time_point start = Clock::now();
+    for (int p = 0; p < SUBMIT_PRODUCERS; p++) {
+        producers.push_back(std::thread([&engine, &producing, p, perProducer]() {
+            for (long i = 0; i < perProducer; i++) {
+                engine.submitOrder(p + (int) (i * SUBMIT_PRODUCERS % SUBMIT_CUSTOMERS));
+            }
+            producing--;
+        }));
+    }
+    long total = perProducer * SUBMIT_PRODUCERS;
+    while (producing.load() > 0 || engine.getOrderCount() < total) {
+        engine.step();
+    }
+    writeRow(csv, run, "submit", total, secondsSince(start));
+    for (std::thread &producer : producers) producer.join();
+
+    vector<long> submitted(SUBMIT_PRODUCERS, 0); // Orders of each producer checked so far
+    OrderInfo info;
+    for (int id = 0; id < engine.getOrderCount(); id++) {
+        engine.getOrder(id, info);
+        int p = info.customerId % SUBMIT_PRODUCERS;
+        int expected = p + (int) (submitted[p] * SUBMIT_PRODUCERS % SUBMIT_CUSTOMERS);
+        if (info.customerId != expected) {
+            std::cerr << "submit: order " << id << " is for customer " << info.customerId << ", its producer submitted "
+                      << expected << " next" << std::endl;
+            return false;
+        }
+        submitted[p]++;
+    }
+    if (engine.getOrderCount() != total) {
+        std::cerr << "submit: " << engine.getOrderCount() << " orders placed, " << total << " submitted" << std::endl;
+        return false;
+    }
+    return true;
+}
+
+static WorkloadSpec makeSpec(const BenchOptions &options, long scale, DispatchPolicy dispatch) {
+    WorkloadSpec spec = WorkloadSpec::forOrders(scale, options.seed);
+    spec.pattern = options.pattern;
+    spec.dispatch = dispatch;
+    if (options.drivers > 0) spec.drivers = options.drivers;
+    spec.driverCapacity = options.capacity;
+    if (options.collectors > 0) spec.collectors = options.collectors;
+    spec.collectorBatch = options.batch;
+    spec.service = options.service;
+    return spec;
+}
+
+/**
+ * Runs every phase on a single scale: config load, orders, steps, status queries, backup, restore and close,
+ * then the journal phases if enabled and orders submitted from several threads.
+ * @returns false if the submitted orders' ids don't match their submission order.
+ */
+static bool runScale(const BenchOptions &options, long scale, DispatchPolicy dispatch, std::ostream &csv) {
+    WorkloadSpec spec = makeSpec(options, scale, dispatch);
+    WorkloadGenerator generator(spec);
+    Run run = {scale, WorkloadGenerator::patternName(spec.pattern),
+               dispatch == DispatchPolicy::Matching ? "matching" : "greedy"};
+    string prefix = options.workdir + "/warehouse_bench_" + std::to_string(scale);
+    string configPath = prefix + ".config", commandsPath = prefix + ".commands";
+    {
+        std::ofstream config(configPath), commands(commandsPath);
+        generator.writeConfig(config);
+        generator.writeCommands(commands);
+    }
+
+    measureOrderMemory(run, scale, csv);
+
+    Clock::time_point start = Clock::now();
+    WareHouse wareHouse(configPath);
+    writeRow(csv, run, "load", spec.customers + spec.collectors + spec.drivers, secondsSince(start));
+
+    // A monitor thread keeps querying the published views, it must never slow the steps down.
+    std::atomic<bool> running(true);
+    std::atomic<long> viewQueries(0);
+    std::thread monitor;
+    if (options.views) {
+        wareHouse.enableReadViews();
+        monitor = std::thread([&wareHouse, &running, &viewQueries]() {
+            long queries = 0;
+            string sink;
+            while (running.load(std::memory_order_relaxed)) {
+                shared_ptr<const ReadView> view = wareHouse.getReadView();
+                int orderId = (int) (queries % std::max(1, view->getOrderCount()));
+                sink = view->orderStatus(orderId);
+                sink = view->customerStatus(orderId % 10);
+                queries++;
+            }
+            viewQueries.store(queries);
+        });
+    }
+    start = Clock::now();
+
+    // Orders and steps are interleaved in the script, each kind is timed on its own.
+    // Throughput is measured up to the last arrival, the final drain step would hide the differences.
+    std::ifstream commands(commandsPath);
+    string line, nextLine;
+    long orders = 0, steps = 0;
+    double orderSeconds = 0, stepSeconds = 0, completedPerStep = 0;
+    bool hasNext = (bool) getline(commands, nextLine);
+    while (hasNext) {
+        line = nextLine;
+        hasNext = (bool) getline(commands, nextLine);
+        if (!hasNext) {
+            completedPerStep = steps > 0 ? (double) wareHouse.getCompletedOrders().size() / steps : 0;
+        }
+        bool isStep = line.compare(0, 5, "step ") == 0;
+        Clock::time_point commandStart = Clock::now();
+        wareHouse.execute(line);
+        if (isStep) {
+            stepSeconds += secondsSince(commandStart);
+            steps += std::atol(line.c_str() + 5);
+        } else {
+            orderSeconds += secondsSince(commandStart);
+            orders++;
+        }
+    }
+    writeRow(csv, run, "order", orders, orderSeconds);
+    writeRow(csv, run, "step", steps, stepSeconds, completedPerStep);
+    if (options.views) {
+        double seconds = secondsSince(start);
+        running.store(false);
+        monitor.join();
+        writeRow(csv, run, "view_query", 2 * viewQueries.load(), seconds);
+    }
+
+    start = Clock::now();
+    long orderCount = std::max(1, wareHouse.getOrderCount());
+    for (int i = 0; i < options.queries; i++) {
+        wareHouse.execute("orderStatus " + std::to_string(orderCount * i / options.queries));
+        wareHouse.execute("customerStatus " + std::to_string((long) spec.customers * i / options.queries));
+        wareHouse.execute("volunteerStatus " + std::to_string((long) wareHouse.getVolunteerCount() * i / options.queries));
+    }
+    writeRow(csv, run, "status", 3L * options.queries, secondsSince(start));
+
+    start = Clock::now();
+    wareHouse.execute("backup");
+    writeRow(csv, run, "backup", 1, secondsSince(start));
+
+    start = Clock::now();
+    wareHouse.execute("restore");
+    writeRow(csv, run, "restore", 1, secondsSince(start));
+
+    start = Clock::now();
+    wareHouse.execute("close");
+    writeRow(csv, run, "close", orderCount, secondsSince(start));
+
+    if (backup != nullptr) {
+        delete backup;
+        backup = nullptr;
+    }
+    if (options.journal) measureJournal(run, configPath, commandsPath, prefix + ".journal", csv);
+    std::remove(configPath.c_str());
+    std::remove(commandsPath.c_str());
+    return measureSubmit(run, scale, csv);
+}
+
+/**
+ * Benchmarks the warehouse on generated workloads of increasing scale and writes a CSV row per phase:
+ * scale,pattern,dispatch,phase,operations,seconds,ops_per_sec,completed_per_step,bytes_per_order
+ * completed_per_step (orders completed per step up to the last arrival) is only set on the step row.
+ * bytes_per_order is only set on the orders_heap/orders_pool rows, whose seconds are the time to copy all the orders.
+ */
+int main(int argc, char **argv) {
+    BenchOptions options;
+    if (!parseOptions(argc, argv, options)) {
+        usage();
+        return 1;
+    }
+
+    if (!options.emit.empty()) { // Only write the workload files, for feeding the warehouse binary by hand.
+        for (long scale : options.scales) {
+            WorkloadGenerator generator(makeSpec(options, scale, options.dispatch[0]));
+            string prefix = options.emit + "_" + std::to_string(scale);
+            std::ofstream config(prefix + ".config"), commands(prefix + ".commands");
+            generator.writeConfig(config);
+            generator.writeCommands(commands);
+            commands << "close\n";
+        }
+        return 0;
+    }
+
+    std::ofstream file;
+    std::ostream csv(std::cout.rdbuf());
+    if (!options.out.empty()) {
+        file.open(options.out);
+        csv.rdbuf(file.rdbuf());
+    }
+    csv << "scale,pattern,dispatch,phase,operations,seconds,ops_per_sec,completed_per_step,bytes_per_order" << std::endl;
+
+    NullBuffer sink;
+    std::streambuf *console = std::cout.rdbuf(&sink);
+    bool consistent = true;
+    for (long scale : options.scales) {
+        for (DispatchPolicy dispatch : options.dispatch) {
+            consistent = runScale(options, scale, dispatch, csv) && consistent;
+        }
+    }
+    std::cout.rdbuf(console);
+    return consistent ? 0 : 1;
+}
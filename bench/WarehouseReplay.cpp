@@ -0,0 +1,108 @@
+#include "../include/WareHouse.h"
+#include "../include/Action.h"
+#include "../include/CommandCodec.h"
+#include "../include/SessionRecorder.h"
+
+#include <iostream>
+#include <algorithm>
+#include <chrono>
+#include <sys/resource.h>
+
+using namespace std;
+
+typedef std::chrono::steady_clock Clock;
+
+/**
+ * A recorded command, decoded before the replay starts.
+ */
+struct ReplayCommand {
+    BaseAction *action; // Binary commands, nullptr for text ones
+    string text;
+    bool isStep;
+
+    ReplayCommand() : action(nullptr), text(), isStep(false) { }
+    ReplayCommand(const ReplayCommand &other) = default; // Doesn't own the action, the replay loop hands it over
+    ReplayCommand &operator=(const ReplayCommand &other) = default;
+};
+
+/**
+ * Nearest rank percentile.
+ * @param sorted the latencies, sorted.
+ */
+static double percentile(const vector<double> &sorted, int percent) {
+    if (sorted.empty()) return 0;
+    unsigned long rank = (sorted.size() * percent + 99) / 100;
+    return sorted[rank == 0 ? 0 : rank - 1];
+}
+
+/**
+ * Replays a session recorded with `warehouse <config> --record <recording>` as fast as possible and reports the
+ * throughput, the latency of the step commands and the peak RSS. The commands are decoded before the clock starts
+ * and their output is muted, so only the engine is measured: step/order/orders don't go through the text parser
+ * at all, the rest of the commands are parsed as they are performed.
+ */
+int main(int argc, char **argv) {
+    if (argc != 3) {
+        std::cerr << "usage: warehouse_replay <config_path> <recording_file>" << std::endl;
+        return 1;
+    }
+    vector<RecordedCommand> recorded;
+    if (!SessionRecorder::load(argv[2], recorded)) {
+        std::cerr << "Not a recording: " << argv[2] << std::endl;
+        return 1;
+    }
+    vector<ReplayCommand> commands(recorded.size());
+    for (unsigned long i = 0; i < recorded.size(); i++) {
+        const string &payload = recorded[i].payload;
+        if (!CommandCodec::decode(payload.data(), payload.size(), commands[i].action, commands[i].text)) {
+            std::cerr << "Malformed command #" << i << " in " << argv[2] << std::endl;
+            return 1;
+        }
+        commands[i].isStep = payload[0] == (char) CommandOpcode::Step;
+    }
+
+    std::cout.setstate(std::ios::failbit);
+    Clock::time_point start = Clock::now();
+    WareHouse wareHouse(argv[1]);
+    double loadSeconds = std::chrono::duration<double>(Clock::now() - start).count();
+
+    vector<double> stepLatencies; // Microseconds
+    unsigned long performed = 0;
+    start = Clock::now();
+    for (ReplayCommand &command : commands) {
+        if (!wareHouse.isOpened()) break;
+        Clock::time_point commandStart = Clock::now();
+        if (command.action) {
+            wareHouse.perform(command.action);
+            command.action = nullptr; // Owned by the warehouse now
+        } else {
+            wareHouse.execute(command.text);
+        }
+        if (command.isStep) {
+            stepLatencies.push_back(std::chrono::duration<double, std::micro>(Clock::now() - commandStart).count());
+        }
+        performed++;
+    }
+    double seconds = std::chrono::duration<double>(Clock::now() - start).count();
+    std::cout.clear();
+    for (ReplayCommand &command : commands) delete command.action; // Commands after close weren't performed
+
+    std::sort(stepLatencies.begin(), stepLatencies.end());
+    rusage usage;
+    getrusage(RUSAGE_SELF, &usage);
+    double recordedSeconds = recorded.empty() ? 0 : recorded.back().micros / 1e6;
+    std::cout << "Config loaded in " << loadSeconds << " s" << std::endl;
+    std::cout << "Replayed " << performed << " commands in " << seconds << " s: "
+              << (seconds > 0 ? performed / seconds : 0) << " commands/sec (the recorded session took "
+              << recordedSeconds << " s)" << std::endl;
+    std::cout << "Step latency (us) over " << stepLatencies.size() << " steps: p50 " << percentile(stepLatencies, 50)
+              << ", p90 " << percentile(stepLatencies, 90) << ", p99 " << percentile(stepLatencies, 99)
+              << ", max " << (stepLatencies.empty() ? 0 : stepLatencies.back()) << std::endl;
+    std::cout << "Peak RSS: " << usage.ru_maxrss << " KB" << std::endl;
+
+    if (backup != nullptr) {
+        delete backup;
+        backup = nullptr;
+    }
+    return 0;
+}
@@ -0,0 +1,268 @@
+#include "../include/WareHouse.h"
+#include "../include/Action.h"
+#include "../include/Volunteer.h"
+#include "../include/ArrivalProcess.h"
+
+#include <iostream>
+#include <fstream>
+#include <sstream>
+#include <chrono>
+#include <algorithm>
+#include <cstdio>
+#include <cstdlib>
+#include <thread>
+#include <atomic>
+#include <mutex>
+#include <unistd.h>
+
+using namespace std;
+
+typedef std::chrono::steady_clock Clock;
+
+struct SweepOptions {
+    string config;
+    vector<double> collectors;
+    vector<double> coolDowns;
+    vector<double> drivers;
+    vector<double> maxDistances;
+    vector<double> distancesPerStep;
+    vector<double> rates; // Mean orders per step
+    int steps; // Steps with arrivals
+    int drain; // Most steps after the last arrival, stops early once the backlog is empty
+    unsigned long long seed;
+    unsigned threads;
+    string out;
+    bool timing; // Whether each combination's wall-clock time is reported on stderr
+
+    SweepOptions() : config(), collectors({1}), coolDowns({1}), drivers({1}), maxDistances({10}),
+                     distancesPerStep({1}), rates({1}), steps(100), drain(100), seed(42),
+                     threads(std::max(1u, std::thread::hardware_concurrency())), out(), timing(false) { }
+};
+
+/**
+ * A single point of the grid.
+ */
+struct SweepPoint {
+    int collectors;
+    int coolDown;
+    int drivers;
+    int maxDistance;
+    int distancePerStep;
+    double rate;
+};
+
+static void usage() {
+    std::cerr << "usage: warehouse_sweep <config_path> [--collectors <range>] [--cooldown <range>] [--drivers <range>]\n"
+                 "                       [--max-distance <range>] [--distance-per-step <range>] [--rate <range>]\n"
+                 "                       [--steps <n>] [--drain <n>] [--seed <s>] [--threads <n>] [--out <csv>]\n"
+                 "                       [--timing on|off]\n"
+                 "A range is a list (2,4,8) or first:last[:increment] (2:10:2).\n";
+}
+
+/**
+ * @param text a comma separated list of values, or first:last[:increment].
+ * @param values set to the values of the range.
+ * @returns false if the range is malformed or empty.
+ */
+static bool parseRange(const string &text, vector<double> &values) {
+    values.clear();
+    if (text.find(':') != string::npos) {
+        double bounds[3] = {0, 0, 1};
+        std::stringstream ss(text);
+        string item;
+        int parts = 0;
+        while (getline(ss, item, ':') && parts < 3) bounds[parts++] = std::atof(item.c_str());
+        if (parts < 2 || bounds[2] <= 0) return false;
+        for (double value = bounds[0]; value <= bounds[1] + 1e-9; value += bounds[2]) values.push_back(value);
+    } else {
+        std::stringstream ss(text);
+        string item;
+        while (getline(ss, item, ',')) values.push_back(std::atof(item.c_str()));
+    }
+    return !values.empty();
+}
+
+static bool parseOptions(int argc, char **argv, SweepOptions &options) {
+    if (argc < 2) return false;
+    options.config = argv[1];
+    for (int i = 2; i < argc; i++) {
+        string arg = argv[i];
+        if (i + 1 >= argc) return false;
+        string value = argv[++i];
+        bool parsed = true;
+        if (arg == "--collectors") parsed = parseRange(value, options.collectors);
+        else if (arg == "--cooldown") parsed = parseRange(value, options.coolDowns);
+        else if (arg == "--drivers") parsed = parseRange(value, options.drivers);
+        else if (arg == "--max-distance") parsed = parseRange(value, options.maxDistances);
+        else if (arg == "--distance-per-step") parsed = parseRange(value, options.distancesPerStep);
+        else if (arg == "--rate") parsed = parseRange(value, options.rates);
+        else if (arg == "--steps") options.steps = std::atoi(value.c_str());
+        else if (arg == "--drain") options.drain = std::atoi(value.c_str());
+        else if (arg == "--seed") options.seed = std::strtoull(value.c_str(), nullptr, 10);
+        else if (arg == "--threads") options.threads = std::max(1, std::atoi(value.c_str()));
+        else if (arg == "--out") options.out = value;
+        else if (arg == "--timing") options.timing = value == "on";
+        else return false;
+        if (!parsed) return false;
+    }
+    return options.steps > 0 && options.drain >= 0;
+}
+
+/**
+ * Nearest rank percentile.
+ * @param sorted the latencies, sorted.
+ */
+static int percentile(const vector<int> &sorted, int percent) {
+    if (sorted.empty()) return 0;
+    unsigned long rank = (sorted.size() * percent + 99) / 100;
+    return sorted[rank == 0 ? 0 : rank - 1];
+}
+
+/**
+ * Simulates a single point of the grid on a fork of the base warehouse and returns its CSV row.
+ * @param seconds set to the wall-clock time of the simulation, kept out of the row so the CSV is deterministic.
+ */
+static string simulate(const WareHouse &base, const SweepOptions &options, const SweepPoint &point,
+                       uint32_t nameId, double &seconds) {
+    Clock::time_point start = Clock::now();
+    WareHouse wareHouse = base.fork();
+    for (int i = 0; i < point.collectors; i++) {
+        wareHouse.addVolunteer(new CollectorVolunteer(wareHouse.getVolunteerCount(), nameId, point.coolDown));
+    }
+    for (int i = 0; i < point.drivers; i++) {
+        wareHouse.addVolunteer(new DriverVolunteer(wareHouse.getVolunteerCount(), nameId, point.maxDistance,
+                                                   point.distancePerStep));
+    }
+    ArrivalProcess arrivals(options.seed, point.rate, ArrivalDistribution::Poisson);
+    long placed = 0, rejected = 0;
+    int customers = wareHouse.getCustomerCount();
+    for (int step = 0; step < options.steps; step++) {
+        long count = arrivals.next();
+        for (long i = 0; i < count && customers > 0; i++) {
+            if (wareHouse.placeOrder(arrivals.pick(customers))) placed++;
+            else rejected++;
+        }
+        wareHouse.step();
+    }
+    int drained = 0;
+    while (drained < options.drain && !(wareHouse.getPendingOrders().empty() &&
+                                        wareHouse.getInProcessOrders().empty())) {
+        wareHouse.step();
+        drained++;
+    }
+    seconds = std::chrono::duration<double>(Clock::now() - start).count();
+
+    vector<int> latencies;
+    for (const Order *order : wareHouse.getCompletedOrders()) latencies.push_back(order->getLatency());
+    std::sort(latencies.begin(), latencies.end());
+    long total = 0;
+    for (int latency : latencies) total += latency;
+    long completed = latencies.size();
+    long backlog = wareHouse.getPendingOrders().size() + wareHouse.getInProcessOrders().size();
+
+    std::ostringstream row;
+    row << point.collectors << "," << point.coolDown << "," << point.drivers << "," << point.maxDistance << ","
+        << point.distancePerStep << "," << point.rate << "," << placed << "," << rejected << "," << completed << ","
+        << backlog << "," << (double) completed / (options.steps + drained) << ",";
+    if (completed > 0) {
+        row << (double) total / completed << "," << percentile(latencies, 50) << "," << percentile(latencies, 99);
+    } else {
+        row << ",,";
+    }
+    return row.str();
+}
+
+/**
+ * Writes the base config without its volunteer lines, the sweep supplies the volunteers.
+ * @returns the path of the written copy, empty if it couldn't be written.
+ */
+static string writeBaseConfig(const string &config) {
+    std::ifstream in(config);
+    char path[] = "/tmp/warehouse_sweep_XXXXXX";
+    int fd = in ? mkstemp(path) : -1;
+    if (fd == -1) return "";
+    close(fd);
+    std::ofstream out(path);
+    string line;
+    while (getline(in, line)) {
+        if (line.compare(0, 9, "volunteer") != 0) out << line << "\n";
+    }
+    return path;
+}
+
+/**
+ * Capacity planning: runs the warehouse of the base config (its customers and policies, without its volunteers)
+ * on every combination of the given volunteer rosters and arrival rates, in parallel, and writes a CSV row per
+ * combination:
+ * collectors,cooldown,drivers,max_distance,distance_per_step,rate,placed,rejected,completed,backlog,
+ * completed_per_step,mean_latency,p50_latency,p99_latency
+ * Orders arrive for --steps steps (Poisson, the same arrivals for every combination of a rate), then the backlog
+ * gets up to --drain more steps. Latencies are empty if no order was completed. The CSV only depends on the
+ * options, --timing on reports the wall-clock time of every combination on stderr.
+ */
+int main(int argc, char **argv) {
+    SweepOptions options;
+    if (!parseOptions(argc, argv, options)) {
+        usage();
+        return 1;
+    }
+    string config = writeBaseConfig(options.config);
+    if (config.empty()) {
+        std::cerr << "Failed to open config file: " << options.config << std::endl;
+        return 1;
+    }
+    WareHouse base(config);
+    std::remove(config.c_str());
+    uint32_t nameId = base.getNames()->intern("sweep");
+
+    vector<SweepPoint> grid;
+    for (double collectors : options.collectors)
+        for (double coolDown : options.coolDowns)
+            for (double drivers : options.drivers)
+                for (double maxDistance : options.maxDistances)
+                    for (double distancePerStep : options.distancesPerStep)
+                        for (double rate : options.rates)
+                            grid.push_back({(int) collectors, std::max(1, (int) coolDown), (int) drivers,
+                                            (int) maxDistance, std::max(1, (int) distancePerStep), rate});
+
+    std::ofstream file;
+    std::ostream csv(std::cout.rdbuf());
+    if (!options.out.empty()) {
+        file.open(options.out);
+        csv.rdbuf(file.rdbuf());
+    }
+    csv << "collectors,cooldown,drivers,max_distance,distance_per_step,rate,placed,rejected,completed,backlog,"
+           "completed_per_step,mean_latency,p50_latency,p99_latency" << std::endl;
+
+    // Rows are written in grid order as soon as all the rows before them are done.
+    vector<string> rows(grid.size());
+    vector<bool> done(grid.size(), false);
+    unsigned long written = 0;
+    std::mutex mutex;
+    std::atomic<unsigned long> next(0);
+    Clock::time_point start = Clock::now();
+    vector<std::thread> pool;
+    for (unsigned i = 0; i < std::min((unsigned long) options.threads, (unsigned long) grid.size()); i++) {
+        pool.push_back(std::thread([&]() {
+            for (unsigned long p = next.fetch_add(1); p < grid.size(); p = next.fetch_add(1)) {
+                double seconds = 0;
+                string row = simulate(base, options, grid[p], nameId, seconds);
+                std::lock_guard<std::mutex> lock(mutex);
+                if (options.timing) std::cerr << "Row " << p + 1 << " simulated in " << seconds << " s" << std::endl;
+                rows[p] = row;
+                done[p] = true;
+                for (; written < grid.size() && done[written]; written++) csv << rows[written] << "\n";
+            }
+        }));
+    }
+    for (std::thread &worker : pool) worker.join();
+    csv.flush();
+    std::cerr << "Simulated " << grid.size() << " configurations on " << pool.size() << " threads in "
+              << std::chrono::duration<double>(Clock::now() - start).count() << " s" << std::endl;
+
+    if (backup != nullptr) {
+        delete backup;
+        backup = nullptr;
+    }
+    return 0;
+}
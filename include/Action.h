@@ -2,6 +2,9 @@
 #include <string>
 #include <vector>
 #include "WareHouse.h"
+#include "ServiceTime.h"
+#include "Scenario.h"
+#include "ArrivalProcess.h"
 using std::string;
 using std::vector;
 
@@ -9,10 +12,6 @@ enum class ActionStatus{
     COMPLETED, ERROR
 };
 
-enum class CustomerType{
-    Soldier, Civilian
-};
-
 enum class VolunteerType{
     Collector, Driver
 };
@@ -28,9 +27,13 @@ class BaseAction{
         virtual void act(WareHouse& wareHouse)=0;
         virtual string toString() const=0;
         virtual BaseAction* clone() const=0;
+        virtual void encode(const string &command, string &payload) const; // Journal form of the performed action
 
         virtual ~BaseAction() = default;
 
+        static void *operator new(size_t size); // Accounted in MemoryCategory::Actions
+        static void operator delete(void *memory, size_t size);
+
     protected:
         void complete();
         void error(string errorMsg);
@@ -68,42 +71,93 @@ class AddOrder : public BaseAction {
 };
 
 
+class AddOrders : public BaseAction {
+    public:
+        AddOrders(int customerId, int count);
+        AddOrders(const vector<int> &customerIds);
+        void act(WareHouse &wareHouse) override;
+        string toString() const override;
+        AddOrders *clone() const override;
+        ~AddOrders() override = default;
+    private:
+        const vector<int> customerIds;
+        const int count; // Orders placed for each of the customers
+        const bool listed; // Whether the customers were given as a list
+};
+
+
+class GenerateOrders : public BaseAction {
+    public:
+        GenerateOrders(int steps, double rate, ArrivalDistribution distribution, unsigned long long seed);
+        void act(WareHouse &wareHouse) override;
+        string toString() const override;
+        GenerateOrders *clone() const override;
+        ~GenerateOrders() override = default;
+    private:
+        const int steps;
+        const double rate; // Mean orders per step
+        const ArrivalDistribution distribution;
+        const unsigned long long seed;
+};
+
+
 class AddCustomer : public BaseAction {
     public:
-        AddCustomer(string customerName, string customerType, int distance, int maxOrders);
+        AddCustomer(const shared_ptr<StringPool> &names, const string &customerName, string customerType, int distance,
+                    int maxOrders);
         void act(WareHouse &wareHouse) override;
         AddCustomer *clone() const override;
         string toString() const override;
         ~AddCustomer() override = default;
     private:
-        const string customerName;
+        const shared_ptr<const StringPool> names; // Shared with the warehouse
+        const uint32_t customerNameId;
         const CustomerType customerType;
         const int distance;
         const int maxOrders;
 };
 
 
+class AddCustomers : public BaseAction {
+    public:
+        AddCustomers(const string &filePath);
+        AddCustomers(const string &filePath, bool opened, const vector<string> &rows); // Rows already read
+        void act(WareHouse &wareHouse) override;
+        AddCustomers *clone() const override;
+        string toString() const override;
+        void encode(const string &command, string &payload) const override;
+        ~AddCustomers() override = default;
+    private:
+        const string filePath;
+        bool read; // Whether the file was read (or the rows were given)
+        bool opened; // Whether the file could be opened
+        vector<string> rows; // The file's rows, without the skipped lines
+};
+
+
 
 class PrintOrderStatus : public BaseAction {
     public:
-        PrintOrderStatus(int id);
+        PrintOrderStatus(int id, int atStep = NO_STEP);
         void act(WareHouse &wareHouse) override;
         PrintOrderStatus *clone() const override;
         string toString() const override;
         ~PrintOrderStatus() override = default;
     private:
         const int orderId;
+        const int atStep; // NO_STEP for the current status
 };
 
 class PrintCustomerStatus: public BaseAction {
     public:
-        PrintCustomerStatus(int customerId);
+        PrintCustomerStatus(int customerId, int atStep = NO_STEP);
         void act(WareHouse &wareHouse) override;
         PrintCustomerStatus *clone() const override;
         string toString() const override;
         ~PrintCustomerStatus() override = default;
     private:
         const int customerId;
+        const int atStep; // NO_STEP for the current status
 };
 
 
@@ -119,14 +173,19 @@ class PrintVolunteerStatus : public BaseAction {
 };
 
 
+#define LOG_ALL (-1)
+
 class PrintActionsLog : public BaseAction {
     public:
-        PrintActionsLog();
+        PrintActionsLog(long from = 0, long count = LOG_ALL, bool tail = false);
         void act(WareHouse &wareHouse) override;
         PrintActionsLog *clone() const override;
         string toString() const override;
         ~PrintActionsLog() override = default;
     private:
+        const long from; // First entry printed, unless tail
+        const long count; // Amount of entries printed, LOG_ALL for all of them
+        const bool tail; // Prints the last count entries
 };
 
 class Close : public BaseAction {
@@ -161,20 +220,128 @@ class RestoreWareHouse : public BaseAction {
 };
 
 
+// The optional key=value arguments of the volunteer config line.
+struct VolunteerOptions {
+    int capacity; // capacity= orders a driver carries per trip
+    int batchSize; // batch= orders a collector picks per cycle
+    int extraCoolDown; // extra_cooldown= time each order beyond the first adds to a collector's cycle
+    ServiceDistribution service; // service= distribution of the cool down/distance of each order
+    int spread; // spread= percent a uniform service time spreads around the nominal one
+
+    VolunteerOptions();
+};
+
 class AddVolunteer : public BaseAction {
     public:
-        AddVolunteer(string name, int coolDown, int maxOrders);
-        AddVolunteer(string name, int maxDistance, int distance_per_step , int maxOrders);
+        AddVolunteer(uint32_t nameId, int coolDown, int maxOrders, const VolunteerOptions &options = VolunteerOptions());
+        AddVolunteer(uint32_t nameId, int maxDistance, int distance_per_step , int maxOrders,
+                     const VolunteerOptions &options = VolunteerOptions());
         void act(WareHouse &wareHouse) override;
         AddVolunteer *clone() const override;
         string toString() const override;
         ~AddVolunteer() override = default;
     private:
-    const string name;
+    const uint32_t nameId; // In the warehouse's StringPool
     const int cooldown;
     const int maxDistance;
     const int distance_per_step;
     const int maxOrders;
+    const VolunteerOptions options;
     const VolunteerType type;
 
-};
\ No newline at end of file
+};
+
+
+class SetDispatchPolicy : public BaseAction {
+    public:
+        SetDispatchPolicy(DispatchPolicy policy);
+        void act(WareHouse &wareHouse) override;
+        SetDispatchPolicy *clone() const override;
+        string toString() const override;
+        ~SetDispatchPolicy() override = default;
+    private:
+        const DispatchPolicy policy;
+};
+
+
+class SetSeed : public BaseAction {
+    public:
+        SetSeed(unsigned long long seed);
+        void act(WareHouse &wareHouse) override;
+        SetSeed *clone() const override;
+        string toString() const override;
+        ~SetSeed() override = default;
+    private:
+        const unsigned long long seed;
+};
+
+
+class SetLogRetention : public BaseAction {
+    public:
+        SetLogRetention(LogRetention retention, unsigned long limit, const string &spillPath);
+        void act(WareHouse &wareHouse) override;
+        SetLogRetention *clone() const override;
+        string toString() const override;
+        ~SetLogRetention() override = default;
+    private:
+        const LogRetention retention;
+        const unsigned long limit;
+        const string spillPath;
+};
+
+class SetScheduler : public BaseAction {
+    public:
+        SetScheduler(SchedulerPolicy policy, int soldierSla, int civilianSla);
+        void act(WareHouse &wareHouse) override;
+        SetScheduler *clone() const override;
+        string toString() const override;
+        ~SetScheduler() override = default;
+    private:
+        const SchedulerPolicy policy;
+        const int soldierSla;
+        const int civilianSla;
+};
+
+
+class PrintLatency : public BaseAction {
+    public:
+        PrintLatency();
+        void act(WareHouse &wareHouse) override;
+        PrintLatency *clone() const override;
+        string toString() const override;
+        ~PrintLatency() override = default;
+    private:
+};
+
+class PrintMemory : public BaseAction {
+    public:
+        PrintMemory();
+        void act(WareHouse &wareHouse) override;
+        PrintMemory *clone() const override;
+        string toString() const override;
+        ~PrintMemory() override = default;
+    private:
+};
+
+class QueryOrders : public BaseAction {
+    public:
+        QueryOrders(const OrderQuery &query);
+        void act(WareHouse &wareHouse) override;
+        QueryOrders *clone() const override;
+        string toString() const override;
+        ~QueryOrders() override = default;
+    private:
+        const OrderQuery query;
+};
+
+class WhatIf : public BaseAction {
+    public:
+        WhatIf(int steps, const vector<ScenarioVariant> &variants);
+        void act(WareHouse &wareHouse) override;
+        WhatIf *clone() const override;
+        string toString() const override;
+        ~WhatIf() override = default;
+    private:
+        const int steps;
+        const vector<ScenarioVariant> variants; // The base scenario first
+};
@@ -2,29 +2,50 @@
 
 #include <string>
 #include <vector>
+#include <memory>
+#include "StringPool.h"
 using std::string;
 using std::vector;
+using std::shared_ptr;
 class BaseAction;
 
 #define STEP "step"
 #define ORDER "order"
+#define ORDERS "orders"
 #define CUSTOMER "customer"
+#define CUSTOMERS "customers"
 #define ORDERSTATUS "orderStatus"
 #define CUSTOMERSTATUS "customerStatus"
 #define VOLUNTEERSTATUS "volunteerStatus"
 #define LOG "log"
+#define LOG_RETENTION "log_retention"
 #define CLOSE "close"
 #define BACKUP "backup"
 #define RESTORE "restore"
 #define VOLUNTEER "volunteer"
+#define DISPATCH "dispatch"
+#define SCHEDULER "scheduler"
+#define LATENCY "latency"
+#define SEED "seed"
+#define QUERY "query"
+#define MEM "mem"
+#define WHATIF "whatif"
+#define GENERATE "generate"
 #define NOT_LIMITED (-1)
 
+vector<string> splitIntoWords(const string &str); // A command's words, without its # comment
+
 class ActionFactory {
 public:
-    ActionFactory();  // Constructor if needed for initializing state
+    ActionFactory(const shared_ptr<StringPool> &names);  // Names in created actions are interned into names
 
     BaseAction* createAction(const std::string& input, bool isOpen);
 
+    static bool parseInt(const string &text, int &value); // Like std::stoi, without throwing
+    static bool parseLong(const string &text, long &value); // Like std::stol, without throwing
+    static bool parseUnsignedLong(const string &text, unsigned long long &value); // Like std::stoull, without throwing
+
 private:
+    shared_ptr<StringPool> names;
 };
 
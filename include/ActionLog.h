@@ -0,0 +1,62 @@
+#pragma once
+#include <string>
+#include <fstream>
+#include <memory>
+#include <cstdint>
+#include "MemoryAccounting.h"
+using std::string;
+using std::shared_ptr;
+
+#define LOG_UNLIMITED 0
+#define SPILL_INDEX_STRIDE 1024 // Spilled entries per offset kept in memory
+
+enum class LogRetention : uint8_t {
+    All,   // Every action is kept in memory, the default
+    Ring,  // Only the last limit actions are kept, older ones are dropped
+    Spill, // Only the last limit actions are kept in memory, older ones are written to a file
+};
+
+/**
+ * The log of the actions performed on a warehouse, owns the logged actions.
+ *
+ * Entries are numbered in the order they were logged, from 0. With a limit, the in-memory entries are a ring
+ * of limit actions: once it's full, logging an action deletes the oldest one (Ring) or first writes its text
+ * to the spill file (Spill). The spill file keeps the offset of every SPILL_INDEX_STRIDE-th spilled entry, so
+ * printing a slice reads only the lines of that slice (and at most a stride before it).
+ *
+ * Copies share the spill file and can print what was spilled before they were made, but a copy never writes to
+ * it - a full copy drops its oldest entries like a ring. Assigning a log (restoring a backup) takes over writing.
+ */
+class ActionLog {
+    public:
+        ActionLog();
+        ActionLog(const ActionLog &other);
+        ActionLog(ActionLog &&other) noexcept;
+        ActionLog &operator=(const ActionLog &other);
+        ActionLog &operator=(ActionLog &&other) noexcept;
+        ~ActionLog();
+
+        bool setRetention(LogRetention retention, unsigned long limit, const string &spillPath);
+        LogRetention getRetention() const;
+        void append(BaseAction *action);
+        long size() const; // Amount of actions ever logged
+        long getFirstKept() const; // The oldest entry that can still be printed
+        void print(long from, long count, std::ostream &out) const;
+        void clear();
+
+    private:
+        ActionList entries; // The in-memory entries, a ring once it holds limit entries
+        unsigned long head; // Position in entries of the oldest in-memory entry
+        long logged; // Amount of actions ever logged
+        LogRetention retention;
+        unsigned long limit; // LOG_UNLIMITED with LogRetention::All
+        shared_ptr<std::fstream> spill; // Shared with copies, nullptr unless spilling
+        bool spilling; // False in copies, they read the spill file but don't write to it
+        long spilled; // Entries 0 to spilled - 1 are in the spill file
+        uint64_t spillBytes; // Where the next spilled entry is written
+        AccountedVector<uint64_t, MemoryCategory::Actions> spillIndex; // Offset of every SPILL_INDEX_STRIDE-th entry
+
+        void copyEntries(const ActionLog &other);
+        void deleteEntries();
+        void spillOldest();
+};
@@ -0,0 +1,36 @@
+#pragma once
+#include <string>
+#include <cstdint>
+using std::string;
+
+#define BURST_PERIOD 10 // Mean amount of steps between bursts of ArrivalDistribution::Bursty
+#define MAX_ARRIVAL_RATE 1000000 // Highest mean orders per step a generate command accepts
+
+enum class ArrivalDistribution : uint8_t {
+    Poisson, // A Poisson distributed amount of orders every step
+    Bursty,  // A burst every BURST_PERIOD steps on average, with the same mean rate
+};
+
+/**
+ * Seeded random order arrivals: how many orders arrive at each step and which customers place them.
+ * The generator is splitmix64 and the samplers don't use the standard library distributions, so a seed gives
+ * the same arrivals on every platform.
+ */
+class ArrivalProcess {
+    public:
+        ArrivalProcess(unsigned long long seed, double rate, ArrivalDistribution distribution);
+        long next(); // Orders arriving at the next step
+        int pick(int count); // Uniform in [0, count)
+
+        static bool parseDistribution(const string &name, ArrivalDistribution &distribution);
+        static string distributionName(ArrivalDistribution distribution);
+
+    private:
+        unsigned long long state;
+        double rate; // Mean orders per step
+        ArrivalDistribution distribution;
+
+        unsigned long long nextBits();
+        double nextDouble(); // Uniform in [0, 1)
+        long poisson(double mean);
+};
@@ -0,0 +1,34 @@
+#pragma once
+#include <string>
+#include <vector>
+#include <cstdint>
+using std::string;
+using std::vector;
+
+class BaseAction;
+class WareHouse;
+
+enum class CommandOpcode : unsigned char {
+    Text,   // The command's text, parsed again when decoded
+    Step,   // step <n>
+    Order,  // order <customer_id>
+    Orders,  // orders <customer_id> <count>
+    Customers // customers <csv_file_path> with the rows read from the file
+};
+
+/**
+ * Binary form of the commands, shared by the journal and the session recorder.
+ * A payload is an opcode byte followed by either int32 arguments (host byte order) or the command's text. Only
+ * commands with plain numeric arguments get the binary form - those are guaranteed to act exactly like their text -
+ * and decoding them builds the action directly, without the text parser. A customers command is encoded with the
+ * rows it read (see encodeCustomers), so it's replayed without the file.
+ */
+class CommandCodec {
+    public:
+        static void encode(const string &command, string &payload); // Appends the command's payload
+        static void encodeCustomers(const string &filePath, bool opened, const vector<string> &rows, string &payload);
+        static bool isStep(const string &command);
+        static bool isGenerate(const string &command);
+        static bool decode(const char *payload, uint32_t size, BaseAction *&action, string &text);
+        static bool perform(const char *payload, uint32_t size, WareHouse &wareHouse);
+};
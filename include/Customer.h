@@ -1,52 +1,96 @@
 #pragma once
 #include <string>
 #include <vector>
+#include <cstdint>
+#include "MemoryAccounting.h"
 using std::string;
 using std::vector;
 
 
 class Order;
 
+enum class CustomerType : uint8_t {
+    Soldier, Civilian
+};
+
+
+typedef AccountedVector<int, MemoryCategory::CustomerOrderIds> OrderIdList;
 
+/**
+ * A customer, stored by value in its warehouse's CustomerTable. Soldiers and civilians behave the same, they
+ * differ only by their type. The customer's order ids are kept by the table, see CustomerTable::getOrdersIds.
+ */
 class Customer {
     public:
-        Customer(int id, const string &name, int locationDistance, int maxOrders);
-        const string &getName() const;
+        Customer(int id, uint32_t nameId, CustomerType type, int locationDistance, int maxOrders);
+        uint32_t getNameId() const; // Id of the name in the warehouse's StringPool
         int getId() const;
+        CustomerType getType() const;
         int getCustomerDistance() const;
         int getMaxOrders() const; //Returns maxOrders
         int getNumOrders() const; //Returns num of orders the customer has made so far
         bool canMakeOrder() const; //Returns true if the customer didn't reach max orders
-        const vector<int> &getOrdersIds() const;
-        int addOrder(int orderId); //return OrderId if order was added successfully, -1 otherwise
-
-        virtual Customer *clone() const = 0; // Return a copy of the customer
-
-        virtual ~Customer() = default;
 
     private:
-        const int id;
-        const string name;
-        const int locationDistance;
-        const int maxOrders;
-        vector<int> ordersId;
-};
+        friend class CustomerTable;
 
+        int id;
+        uint32_t nameId;
+        int locationDistance;
+        int maxOrders;
+        int numOrders;
+        uint32_t ordersStart; // Offset of the customer's order ids in the table's flat array
+        int ordersCapacity; // Slots reserved for the customer's order ids from ordersStart
+        CustomerType type;
+};
 
-class SoldierCustomer: public Customer {
+/**
+ * A customer's order ids, oldest first. A view into the CustomerTable's flat array, valid until the next order
+ * is placed by any customer of the table.
+ */
+class OrderIdRange {
     public:
-        SoldierCustomer(int id, string name, int locationDistance, int maxOrders);
-        SoldierCustomer *clone() const override;
-    
+        OrderIdRange(const int *first, int count);
+        const int *begin() const;
+        const int *end() const;
+        int size() const;
+        bool empty() const;
+        int operator[](int index) const;
+        int back() const;
+
     private:
-        
+        const int *first;
+        int count;
 };
 
-class CivilianCustomer: public Customer {
+/**
+ * All the customers of a warehouse, stored contiguously by value and indexed by customer id.
+ *
+ * The order ids of all the customers share a single flat array, each customer owns a region of it (offset and
+ * capacity) holding its ids in order. A full region doubles, up to the customer's max orders: in place when
+ * it's the last region, otherwise it moves to the end of the array and its old slots are left unused. Once
+ * more than half of the array is unused the regions are packed again, in id order.
+ *
+ * Customers and order ids are plain data, copying the table (e.g. for a backup) copies two arrays.
+ */
+class CustomerTable {
     public:
-        CivilianCustomer(int id, string name, int locationDistance, int maxOrders);
-        CivilianCustomer *clone() const override;
-    
+        CustomerTable();
+
+        int add(uint32_t nameId, CustomerType type, int locationDistance, int maxOrders); // Returns the new id
+        void reserve(unsigned long count);
+        int size() const;
+        const Customer *find(int customerId) const;
+        const Customer &operator[](int customerId) const; // Doesn't check the id
+        bool addOrder(int customerId, int orderId);
+        OrderIdRange getOrdersIds(int customerId) const;
+        void clear();
+
     private:
-        
-};
\ No newline at end of file
+        AccountedVector<Customer, MemoryCategory::Customers> customers; // Customer ids are their indices
+        OrderIdList orderIds; // The regions of all the customers
+        unsigned long unused; // Slots of orderIds left behind by regions that moved
+
+        void grow(Customer &customer);
+        void pack();
+};
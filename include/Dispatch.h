@@ -0,0 +1,41 @@
+#pragma once
+#include <vector>
+using std::vector;
+
+enum class DispatchPolicy {
+    Greedy,   // Each awaiting order takes the first free driver that can take it
+    Matching, // Each step's driver assignment is solved as a min-cost bipartite matching
+};
+
+/**
+ * Free drivers are grouped by (maxDistance, distancePerStep), drivers of the same class are interchangeable.
+ */
+struct DriverClass {
+    int maxDistance;
+    int distancePerStep;
+    int count;
+};
+
+/**
+ * Solves the driver assignment of a single step as a bipartite matching: first maximize the amount of matched
+ * orders, then minimize the total amount of delivery steps (ceil(distance / distancePerStep)).
+ * Orders are grouped by distance and drivers by class, which turns it into a small transportation problem
+ * solved exactly with min-cost max-flow, no matter how many orders/drivers there are.
+ */
+class DriverMatcher {
+    public:
+        static vector<int> match(const vector<int> &distances, const vector<DriverClass> &classes);
+
+    private:
+        struct Edge {
+            int to;
+            int capacity;
+            int cost;
+        };
+        vector<Edge> edges; // Edge i's reverse edge is i ^ 1
+        vector<vector<int>> graph;
+
+        DriverMatcher(int nodes);
+        int addEdge(int from, int to, int capacity, int cost);
+        void minCostMaxFlow(int source, int sink);
+};
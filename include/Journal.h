@@ -0,0 +1,56 @@
+#pragma once
+#include <string>
+#include <mutex>
+#include <condition_variable>
+#include <thread>
+using std::string;
+
+class WareHouse;
+
+/**
+ * Write-ahead log of the commands performed on a warehouse, so a crashed session can be restored by replaying
+ * it after the config.
+ *
+ * The file starts with JOURNAL_MAGIC followed by a record per command: its payload length and checksum (4 bytes
+ * each, host byte order) and the command's CommandCodec payload.
+ *
+ * append() only copies the record into a buffer. A writer thread writes and fsyncs whatever accumulated while
+ * the previous fsync ran (group commit), so the REPL never waits for the disk; a crash may lose the commands
+ * of the last batch, never leave a half replayed one. A batch is only acknowledged (counted as durable) once
+ * its fsync succeeded. A failed write or fsync is reported and ends the journal: later commands aren't written,
+ * as replaying them without the lost batch would restore a different session.
+ */
+class Journal {
+    public:
+        Journal(const string &path);
+        void append(const string &command);
+        void appendPayload(const string &payload); // A command already encoded by CommandCodec
+        bool flush(); // Blocks until everything appended so far is on disk, false if the journal failed
+        bool isOpen() const;
+        bool hasFailed() const;
+        unsigned long getAppended() const;
+        unsigned long getSyncs() const;
+        ~Journal(); // Flushes the rest of the journal
+
+        Journal(const Journal &other) = delete;
+        Journal &operator=(const Journal &other) = delete;
+
+        static long replay(const string &path, WareHouse &wareHouse);
+
+    private:
+        int fd;
+        mutable std::mutex mutex;
+        std::condition_variable wake; // Signaled when there's something to write or the journal is closing
+        std::condition_variable synced; // Signaled after every fsync
+        string pending; // Records waiting for the writer
+        string writing; // Records being written, only touched by the writer
+        unsigned long appended; // Amount of commands appended
+        unsigned long durable; // Amount of commands known to be on disk
+        unsigned long syncs;
+        bool closing;
+        bool failed; // A write or fsync failed, nothing is written anymore
+        std::thread writer;
+
+        void writeBatches();
+        static void frame(const string &payload, string &record);
+};
@@ -0,0 +1,141 @@
+#pragma once
+#include <vector>
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+#include <new>
+using std::vector;
+
+/**
+ * What an accounted allocation belongs to.
+ */
+enum class MemoryCategory : uint8_t {
+    PendingOrders,   // The pendingOrders vector
+    InProcessOrders, // The inProcessOrders vector
+    CompletedOrders, // The completedOrders vector
+    OrderPool,       // The orders themselves
+    OrderIndexes,    // OrderIndex
+    OrderHistory,    // OrderHistory
+    Customers,       // The customers table
+    CustomerOrderIds, // The customers' order ids array
+    Volunteers,      // Volunteer objects and the volunteers vector
+    Actions,         // BaseAction objects and the actionsLog vector
+    Names,           // StringPool
+};
+
+#define MEMORY_CATEGORY_COUNT 11
+
+/**
+ * Live bytes and objects of every category at some point.
+ */
+struct MemoryUsage {
+    long bytes[MEMORY_CATEGORY_COUNT];
+    long objects[MEMORY_CATEGORY_COUNT]; // Only counted for the categories of polymorphic objects
+
+    MemoryUsage();
+    MemoryUsage operator+(const MemoryUsage &other) const;
+    MemoryUsage operator-(const MemoryUsage &other) const;
+    long totalBytes() const;
+};
+
+/**
+ * The counters of the memory one owner allocates, by category - every warehouse has its own context, so do
+ * shared string pools. Allocations are charged to the context current on the allocating thread (see
+ * MemoryScope) and credited back to that same context when they're freed, whichever thread or scope frees them.
+ *
+ * A context is reference counted: its owner holds one reference and every live allocation charged to it holds
+ * another, so a context outlives its owner until the last of its allocations is freed. The counters are atomic
+ * (relaxed), allocations may be freed on any thread.
+ */
+class MemoryContext {
+    public:
+        static MemoryContext *create(); // Holds the caller's reference
+        static MemoryContext *current(); // Of the calling thread
+        static MemoryContext *unattributed(); // Current outside of any scope, never freed
+
+        MemoryContext(const MemoryContext &other) = delete;
+        MemoryContext &operator=(const MemoryContext &other) = delete;
+        void retain();
+        void release();
+        MemoryUsage getUsage() const;
+
+    private:
+        friend class MemoryAccounting;
+        MemoryContext();
+
+        std::atomic<long> liveBytes[MEMORY_CATEGORY_COUNT];
+        std::atomic<long> liveObjects[MEMORY_CATEGORY_COUNT];
+        std::atomic<long> references;
+};
+
+/**
+ * Makes a context current on this thread for the scope's lifetime, the previous one is current again after it.
+ * Scopes nest.
+ */
+class MemoryScope {
+    public:
+        explicit MemoryScope(MemoryContext *context);
+        MemoryScope(const MemoryScope &other) = delete;
+        MemoryScope &operator=(const MemoryScope &other) = delete;
+        ~MemoryScope();
+
+    private:
+        MemoryContext *previous;
+};
+
+/**
+ * The accounted allocations: every allocation of the accounted containers (through AccountedAllocator) and of
+ * the Volunteer/BaseAction objects (through their operator new) is charged with the exact size requested from
+ * the allocator, so a context's counters are what is live, not an estimate from the containers' sizes.
+ * Allocator bookkeeping overhead isn't included.
+ *
+ * Every allocation starts with a small header recording the context it was charged to and its size, which is
+ * how a free finds the context to credit and how adopt() moves an object between contexts.
+ */
+class MemoryAccounting {
+    public:
+        static void *allocate(MemoryCategory category, size_t bytes, long objects);
+        static void deallocate(void *memory, MemoryCategory category, long objects) noexcept;
+        static void adopt(void *memory, MemoryCategory category, long objects, MemoryContext *context);
+        static const char *categoryName(MemoryCategory category);
+};
+
+/**
+ * A std::allocator that charges its allocations to the category's counters of the current context. Stateless,
+ * all allocators of the same category are interchangeable - a free always credits the context the memory was
+ * charged to.
+ */
+template <class T, MemoryCategory category>
+class AccountedAllocator {
+    public:
+        typedef T value_type;
+        template <class U> struct rebind { typedef AccountedAllocator<U, category> other; };
+
+        AccountedAllocator() noexcept { }
+        template <class U> AccountedAllocator(const AccountedAllocator<U, category> &) noexcept { }
+
+        T *allocate(size_t count) {
+            return static_cast<T*>(MemoryAccounting::allocate(category, count * sizeof(T), 0));
+        }
+
+        void deallocate(T *memory, size_t) noexcept {
+            MemoryAccounting::deallocate(memory, category, 0);
+        }
+
+        template <class U> bool operator==(const AccountedAllocator<U, category> &) const noexcept { return true; }
+        template <class U> bool operator!=(const AccountedAllocator<U, category> &) const noexcept { return false; }
+};
+
+template <class T, MemoryCategory category>
+using AccountedVector = vector<T, AccountedAllocator<T, category>>;
+
+class Order;
+class Volunteer;
+class BaseAction;
+
+// The accounted containers of a warehouse.
+typedef AccountedVector<Order*, MemoryCategory::PendingOrders> PendingOrderList;
+typedef AccountedVector<Order*, MemoryCategory::InProcessOrders> InProcessOrderList;
+typedef AccountedVector<Order*, MemoryCategory::CompletedOrders> CompletedOrderList;
+typedef AccountedVector<Volunteer*, MemoryCategory::Volunteers> VolunteerList;
+typedef AccountedVector<BaseAction*, MemoryCategory::Actions> ActionList;
@@ -2,13 +2,14 @@
 
 #include <string>
 #include <vector>
+#include <cstdint>
 using std::string;
 using std::vector;
 
 
 class Volunteer;
 
-enum class OrderStatus {
+enum class OrderStatus : uint8_t {
     PENDING,
     COLLECTING,
     DELIVERING,
@@ -16,6 +17,7 @@ enum class OrderStatus {
 };
 
 #define NO_VOLUNTEER -1
+#define NO_STEP -1
 
 class Order {
 
@@ -33,13 +35,21 @@ class Order {
 
         // Student's extra fucntions
         int getDistance() const;
+        void setCreatedStep(int step);
+        void setCompletedStep(int step);
+        int getCreatedStep() const;
+        int getCompletedStep() const;
+        int getLatency() const; // Steps from placement to completion, NO_STEP if not completed yet
         ~Order() = default;
 
     private:
-        const int id;
-        const int customerId;
-        const int distance;
+        // Orders are kept packed and trivially copyable (see OrderPool), so the fields aren't const.
+        int32_t id;
+        int32_t customerId;
+        int32_t distance;
+        int32_t collectorId; //Initialized to NO_VOLUNTEER if no collector has been assigned yet
+        int32_t driverId; //Initialized to NO_VOLUNTEER if no driver has been assigned yet
+        int32_t createdStep; //The step the order was placed at
+        int32_t completedStep; //Initialized to NO_STEP until the order is completed
         OrderStatus status;
-        int collectorId; //Initialized to NO_VOLUNTEER if no collector has been assigned yet
-        int driverId; //Initialized to NO_VOLUNTEER if no driver has been assigned yet
 };
\ No newline at end of file
@@ -0,0 +1,36 @@
+#pragma once
+#include <vector>
+#include <cstdint>
+#include "Order.h"
+#include "MemoryAccounting.h"
+using std::vector;
+
+/**
+ * Every transition of every order of a warehouse, so an order's state at any past step is looked up instead of
+ * restored from a backup.
+ *
+ * Transitions are (step, status, volunteer) records appended in columns, in the order they happen, so the steps
+ * column is ascending. Each record also points at the previous record of the same order and each order points
+ * at its latest record. The state at step T is found by binary searching the steps column for the records that
+ * happened by T, then following the order's records back to the latest of them (an order has a handful).
+ *
+ * A record's step is the amount of steps performed when its state became visible: an order placed between
+ * steps 3 and 4 is recorded at 3, an order a collector picks during step 4 is recorded at 4. The state at step T
+ * is thus the state right before step T + 1 is performed.
+ */
+class OrderHistory {
+    public:
+        OrderHistory();
+
+        void record(int orderId, int step, OrderStatus status, int volunteerId);
+        bool stateAt(const Order &order, int step, Order &past) const;
+        void clear();
+        unsigned long memoryUsage() const; // Bytes reserved by the history
+
+    private:
+        AccountedVector<int32_t, MemoryCategory::OrderHistory> steps;
+        AccountedVector<OrderStatus, MemoryCategory::OrderHistory> statuses;
+        AccountedVector<int32_t, MemoryCategory::OrderHistory> volunteers; // The collector or driver the order was handed to, NO_VOLUNTEER if none
+        AccountedVector<uint32_t, MemoryCategory::OrderHistory> previous; // The previous record of the same order, NO_RECORD for its first one
+        AccountedVector<uint32_t, MemoryCategory::OrderHistory> latest; // Indexed by order id, the order's latest record
+};
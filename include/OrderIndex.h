@@ -0,0 +1,63 @@
+#pragma once
+#include <string>
+#include <vector>
+#include <map>
+#include "Order.h"
+#include "OrderPool.h"
+#include "MemoryAccounting.h"
+using std::string;
+using std::vector;
+using std::map;
+
+#define ORDER_STATUS_COUNT 4
+#define ANY_CUSTOMER (-1)
+#define NO_LIMIT (-1)
+
+typedef AccountedVector<int, MemoryCategory::OrderIndexes> IndexedOrders;
+typedef AccountedVector<IndexedOrders, MemoryCategory::OrderIndexes> IndexedOrderLists;
+
+/**
+ * The predicates of a `query orders` command, an order matches if it satisfies all of them.
+ */
+struct OrderQuery {
+    bool byStatus;
+    OrderStatus status;
+    int customerId; // ANY_CUSTOMER if not filtered
+    int collectorId; // NO_VOLUNTEER if not filtered
+    int driverId; // NO_VOLUNTEER if not filtered
+    int minDistance; // Inclusive
+    int maxDistance; // Inclusive
+    int limit; // Most orders printed, NO_LIMIT for all of them
+
+    OrderQuery();
+    bool matches(const Order &order) const;
+    string toString() const; // The predicates, as given to the query command
+};
+
+/**
+ * Secondary indexes over the orders of a warehouse - by status, by customer, by assigned volunteer and by
+ * distance. The warehouse updates them on every transition, so a query reads only the orders of its most
+ * selective index instead of scanning all of the orders.
+ *
+ * Order ids in the customer and distance lists are ascending. The status buckets are unordered, an order
+ * leaving a bucket is swapped with the bucket's last order (O(1)).
+ */
+class OrderIndex {
+    public:
+        OrderIndex();
+
+        void add(const Order &order); // A newly placed order
+        void assign(const Order &order, int volunteerId);
+        void changeStatus(const Order &order, OrderStatus previous); // After order's status was changed
+        vector<int> query(const OrderQuery &query, const OrderPool &orders, int &matched) const;
+        void clear();
+        unsigned long memoryUsage() const; // Bytes reserved by the indexes
+
+    private:
+        IndexedOrderLists byStatus; // Indexed by OrderStatus
+        IndexedOrders statusPosition; // Indexed by order id, the order's position in its status bucket
+        IndexedOrderLists byCustomer; // Indexed by customer id
+        IndexedOrderLists byVolunteer; // Indexed by volunteer id, the orders it collected or delivered
+        map<int, IndexedOrders, std::less<int>,
+            AccountedAllocator<std::pair<const int, IndexedOrders>, MemoryCategory::OrderIndexes>> byDistance;
+};
@@ -0,0 +1,41 @@
+#pragma once
+#include <vector>
+#include <memory>
+#include "Order.h"
+#include "MemoryAccounting.h"
+using std::vector;
+using std::shared_ptr;
+
+typedef AccountedVector<Order, MemoryCategory::OrderPool> OrderChunk;
+
+/**
+ * Owns all the orders of a warehouse, stored contiguously in fixed size chunks and indexed by order id.
+ * Chunks are never reallocated, so pointers to orders stay valid until the pool is cleared. Orders are trivially
+ * copyable, copying a pool (e.g. for a backup) is a memcpy per chunk.
+ *
+ * Chunks are reference counted so a fork's pool can share them: a forked pool copies only the chunks it may
+ * change and shares the rest, which hold completed orders only and are never changed by any of their pools.
+ */
+class OrderPool {
+    public:
+        OrderPool();
+        OrderPool(const OrderPool &other);
+        OrderPool(const OrderPool &other, const vector<int> &changingIds);
+        OrderPool(OrderPool &&other) noexcept;
+        OrderPool &operator=(const OrderPool &other);
+        OrderPool &operator=(OrderPool &&other) noexcept;
+        ~OrderPool() = default;
+
+        Order &add(const Order &order); // Stored at the order's id
+        Order *find(int orderId) const;
+        int size() const; // One past the highest stored id
+        void clear();
+        unsigned long memoryUsage() const; // Bytes reserved by the pool
+
+    private:
+        AccountedVector<shared_ptr<OrderChunk>, MemoryCategory::OrderPool> chunks; // Each chunk's capacity is ORDER_POOL_CHUNK
+        int count;
+
+        void copyFrom(const OrderPool &other);
+        static shared_ptr<OrderChunk> copyChunk(const OrderChunk &chunk);
+};
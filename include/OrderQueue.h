@@ -0,0 +1,27 @@
+#pragma once
+#include <atomic>
+
+/**
+ * Lock-free multi-producer single-consumer queue of order requests (Vyukov's MPSC queue).
+ * Any thread may push, a push is a single atomic exchange. Only one thread (the simulation thread) may pop.
+ * Items are popped in the order in which their pushes were linearized.
+ */
+class OrderQueue {
+    public:
+        OrderQueue();
+        void push(int customerId); // Thread safe
+        bool pop(int &customerId); // Consumer thread only, false if the queue is (momentarily) empty
+        ~OrderQueue();
+
+        OrderQueue(const OrderQueue &other) = delete;
+        OrderQueue &operator=(const OrderQueue &other) = delete;
+
+    private:
+        struct Node {
+            std::atomic<Node*> next;
+            int customerId;
+            explicit Node(int customerId) : next(nullptr), customerId(customerId) { }
+        };
+        std::atomic<Node*> head; // Last pushed node, producers swing it
+        Node *tail; // Consumed dummy node, its successor is the next item
+};
@@ -0,0 +1,55 @@
+#pragma once
+#include <string>
+#include <vector>
+#include <atomic>
+#include <fstream>
+using std::string;
+using std::vector;
+
+enum class TracePhase : unsigned char {
+    Pending, Collecting, AwaitingDriver, Delivering, Completed
+};
+
+struct TraceEvent {
+    int step;
+    int orderId;
+    int volunteerId; // NO_VOLUNTEER for Pending
+    TracePhase phase;
+};
+
+/**
+ * Records the lifecycle of every order and writes it as a Chrome trace-event JSON file (readable by Perfetto
+ * and chrome://tracing). Each order is a track, each phase a slice on it, one step is shown as one millisecond.
+ *
+ * Events are appended to a fixed buffer by reserving a slot with a single atomic increment, so recording never
+ * blocks. The buffer is drained by flush(), which must only be called while nobody is recording (the warehouse
+ * calls it at the end of each step). Events that don't fit in the buffer are dropped and counted. Slices are
+ * only ended if they were begun, so a dropped event never leaves an unmatched end, and slices whose end was
+ * dropped are ended at the last written timestamp when the tracer is destroyed.
+ */
+class OrderTracer {
+    public:
+        OrderTracer(const string &path, unsigned long capacity = 1 << 20);
+        void record(int step, int orderId, TracePhase phase, int volunteerId);
+        void flush();
+        void flushIfFull(); // Flushes once the buffer is half full
+        bool isOpen() const;
+        unsigned long getDropped() const;
+        ~OrderTracer();
+
+        OrderTracer(const OrderTracer &other) = delete;
+        OrderTracer &operator=(const OrderTracer &other) = delete;
+
+    private:
+        vector<TraceEvent> events;
+        std::atomic<unsigned long> head; // Next free slot in events
+        std::atomic<unsigned long> dropped;
+        std::ofstream out;
+        bool firstEvent;
+        vector<bool> openSlices; // Indexed by order id, whether the order's current phase slice was begun
+        long lastTs; // Timestamp of the last written event
+
+        void endSlice(int orderId, long ts);
+
+        void writeEvent(const TraceEvent &event);
+};
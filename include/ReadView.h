@@ -0,0 +1,68 @@
+#pragma once
+#include <string>
+#include <vector>
+#include <memory>
+#include "Order.h"
+#include "MemoryAccounting.h"
+using std::string;
+using std::vector;
+using std::shared_ptr;
+
+class CustomerTable;
+class Volunteer;
+
+/**
+ * An immutable, versioned snapshot of the warehouse, published by the simulation thread after each step.
+ * Status queries can be answered from it on any thread while the simulation keeps running.
+ *
+ * Publishing is read-copy-update: a new view shares every chunk of orders/customers and every volunteer that
+ * didn't change since the previous view and copies only the touched ones. Old views are reclaimed once their last reader drops
+ * its shared_ptr.
+ */
+class ReadView {
+    public:
+        ReadView();
+        long getVersion() const;
+        int getStep() const;
+        int getOrderCount() const;
+        string orderStatus(int orderId) const; // Same output as the orderStatus command
+        string customerStatus(int customerId) const; // Same output as the customerStatus command
+        string volunteerStatus(int volunteerId) const; // Same output as the volunteerStatus command
+
+        static shared_ptr<const ReadView> publish(const shared_ptr<const ReadView> &previous, long version, int step,
+                                                  const vector<const Order*> &changedOrders,
+                                                  const CustomerTable &customers,
+                                                  const vector<int> &changedCustomers,
+                                                  const VolunteerList &volunteers,
+                                                  const vector<int> &changedVolunteers);
+
+    private:
+        struct OrderRecord {
+            int id; // NO_ORDER_RECORD if there's no such order
+            int customerId;
+            int distance;
+            int collectorId;
+            int driverId;
+            int previousOfCustomer; // The customer's previous order, customers' orders form lists
+            OrderStatus status;
+        };
+        struct CustomerRecord {
+            int id; // NO_CUSTOMER_RECORD if there's no such customer
+            int maxOrders;
+            int numOrders;
+            int lastOrderId; // Head of the customer's orders list
+        };
+        typedef vector<OrderRecord> OrderChunk;
+        typedef vector<CustomerRecord> CustomerChunk;
+
+        long version;
+        int step;
+        int orderCount;
+        vector<shared_ptr<const OrderChunk>> orders; // Order i is orders[i / ORDER_CHUNK][i % ORDER_CHUNK]
+        vector<shared_ptr<const CustomerChunk>> customers;
+        vector<shared_ptr<const Volunteer>> volunteers;
+
+        const OrderRecord *findOrder(int orderId) const;
+        OrderRecord &writableOrder(int orderId, vector<OrderChunk*> &writable);
+        const CustomerRecord *findCustomer(int customerId) const;
+};
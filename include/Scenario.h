@@ -0,0 +1,76 @@
+#pragma once
+#include <string>
+#include <vector>
+#include <cstdint>
+#include <mutex>
+#include <condition_variable>
+#include <thread>
+using std::string;
+using std::vector;
+
+class WareHouse;
+
+#define SCENARIO_VOLUNTEER_NAME "whatif"
+#define MAX_SCENARIO_VOLUNTEERS 10000 // Collectors, and drivers, a variant may add
+#define MAX_SCENARIO_ORDERS 1000000 // Orders a variant may inject
+
+/**
+ * The changes a what-if scenario makes to its fork of the warehouse before stepping it.
+ */
+struct ScenarioVariant {
+    string name; // As given to the whatif command, "base" for no changes
+    int collectors; // Collectors added
+    int collectorCoolDown;
+    int drivers; // Drivers added
+    int driverMaxDistance;
+    int driverDistancePerStep;
+    uint32_t volunteerNameId; // Name of the added volunteers, in the warehouse's StringPool
+    int orders; // Orders injected, one per customer in turn while they can still order
+
+    ScenarioVariant();
+};
+
+/**
+ * Where a scenario ended up after its steps.
+ */
+struct ScenarioOutcome {
+    int completed; // Orders completed during the scenario's steps
+    int backlog; // Orders still pending or in process at the end
+    double meanLatency; // Of the orders completed during the scenario, -1 if there are none
+
+    ScenarioOutcome();
+};
+
+/**
+ * Runs what-if scenarios: every variant gets its own fork of the warehouse (see WareHouse::fork), applies its
+ * changes and performs the steps. The scenarios are independent, the runner's worker threads take them one at
+ * a time and each worker makes the forks of its own scenarios. The warehouse itself is only read.
+ *
+ * The workers are started with the runner and wait for the next run between runs, so a run doesn't pay for
+ * starting threads. run() must only be called by one thread at a time.
+ */
+class ScenarioRunner {
+    public:
+        ScenarioRunner(); // Starts a worker per hardware thread
+        vector<ScenarioOutcome> run(const WareHouse &wareHouse, int steps, const vector<ScenarioVariant> &variants);
+        ~ScenarioRunner(); // Stops the workers
+
+        ScenarioRunner(const ScenarioRunner &other) = delete;
+        ScenarioRunner &operator=(const ScenarioRunner &other) = delete;
+
+    private:
+        std::mutex mutex;
+        std::condition_variable wake; // Signaled when a run starts or the runner is stopping
+        std::condition_variable finished; // Signaled when the last scenario of a run is done
+        const WareHouse *wareHouse; // Of the current run, the fields below too
+        int steps;
+        const vector<ScenarioVariant> *variants; // nullptr between runs
+        vector<ScenarioOutcome> *outcomes;
+        unsigned long next; // The next variant a worker takes
+        unsigned long done; // Amount of scenarios of the run that are done
+        bool stopping;
+        vector<std::thread> workers;
+
+        void work();
+        static ScenarioOutcome runScenario(const WareHouse &wareHouse, int steps, const ScenarioVariant &variant);
+};
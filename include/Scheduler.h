@@ -0,0 +1,99 @@
+#pragma once
+#include <string>
+#include <vector>
+#include "Order.h"
+#include "Customer.h"
+#include "MemoryAccounting.h"
+using std::string;
+using std::vector;
+
+#define DEFAULT_SOLDIER_SLA 5
+#define DEFAULT_CIVILIAN_SLA 15
+
+enum class SchedulerPolicy {
+    Fifo,     // First come first served
+    Priority, // Soldiers first
+    Edf,      // Earliest deadline first
+};
+
+/**
+ * Decides in which order the pending orders get the free volunteers at each step.
+ * Every step the pending orders are ranked and heapified once (O(n)), then each assignment pops the next
+ * order in O(log n). Orders of the same rank are taken in their queue order, so a scheduler that ranks all
+ * orders the same is exactly the original first come first served loop - such a scheduler skips the heap.
+ */
+class Scheduler {
+    public:
+        Scheduler();
+        void schedule(const PendingOrderList &orders, const CustomerTable &customers);
+        bool hasNext() const;
+        unsigned long next(); // Position in the scheduled vector of the next order to serve
+
+        virtual Scheduler *clone() const = 0;
+        virtual string toString() const = 0; // The config line selecting this scheduler
+        virtual ~Scheduler() = default;
+
+        static Scheduler *create(SchedulerPolicy policy, int soldierSla, int civilianSla);
+
+    protected:
+        // Lower ranks are served first.
+        virtual long rank(const Order &order, const Customer &customer) const = 0;
+        // True if all orders have the same rank, orders are then served in queue order without a heap.
+        virtual bool keepsQueueOrder() const;
+
+    private:
+        struct Entry {
+            long rank;
+            unsigned long position;
+        };
+        vector<Entry> heap;
+        unsigned long queued; // Amount of scheduled orders, when keepsQueueOrder()
+        unsigned long served; // Amount of orders served so far, when keepsQueueOrder()
+
+        static bool servedAfter(const Entry &a, const Entry &b);
+};
+
+/**
+ * First come first served - today's behavior.
+ */
+class FifoScheduler : public Scheduler {
+    public:
+        FifoScheduler();
+        FifoScheduler *clone() const override;
+        string toString() const override;
+
+    protected:
+        long rank(const Order &order, const Customer &customer) const override;
+        bool keepsQueueOrder() const override;
+};
+
+/**
+ * Strict priority - soldiers' orders are always served before civilians' orders.
+ */
+class PriorityScheduler : public Scheduler {
+    public:
+        PriorityScheduler();
+        PriorityScheduler *clone() const override;
+        string toString() const override;
+
+    protected:
+        long rank(const Order &order, const Customer &customer) const override;
+};
+
+/**
+ * Earliest deadline first - each order is due a fixed amount of steps (its customer type's SLA) after it
+ * was placed, the order due first is served first.
+ */
+class EdfScheduler : public Scheduler {
+    public:
+        EdfScheduler(int soldierSla, int civilianSla);
+        EdfScheduler *clone() const override;
+        string toString() const override;
+
+    protected:
+        long rank(const Order &order, const Customer &customer) const override;
+
+    private:
+        const int soldierSla;
+        const int civilianSla;
+};
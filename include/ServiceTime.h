@@ -0,0 +1,38 @@
+#pragma once
+#include <string>
+#include <cstdint>
+using std::string;
+
+#define DEFAULT_SERVICE_SPREAD 50
+
+enum class ServiceDistribution : uint8_t {
+    Fixed,       // The nominal time, today's behavior
+    Uniform,     // Uniform around the nominal time, +-spread percent
+    Exponential  // Exponential with the nominal time as its mean
+};
+
+/**
+ * How long a volunteer takes to serve an order: a collector's cool down, a driver's distance to the customer.
+ *
+ * Samples come from Philox4x32-10, a counter-based generator: the random bits are a pure function of the seed
+ * (the key) and of the volunteer and order ids (the counter). There's no generator state, so a sample doesn't
+ * depend on which orders were served before it, in what order or on which thread - the same seed always gives
+ * the same run. A sample is a fixed sequence of multiplications without branches or memory accesses.
+ */
+class ServiceTime {
+    public:
+        ServiceTime(); // Fixed
+        ServiceTime(ServiceDistribution distribution, int spread);
+        void setSeed(unsigned long long seed);
+        int sample(int nominal, int volunteerId, int orderId) const;
+        ServiceDistribution getDistribution() const;
+        int getSpread() const;
+
+        static bool parseDistribution(const string &name, ServiceDistribution &distribution);
+        static string distributionName(ServiceDistribution distribution);
+
+    private:
+        ServiceDistribution distribution;
+        int spread; // Percent, used by Uniform
+        uint32_t key[2]; // The seed
+};
@@ -0,0 +1,44 @@
+#pragma once
+#include <string>
+#include <vector>
+#include <fstream>
+#include <chrono>
+using std::string;
+using std::vector;
+
+/**
+ * A command of a recorded session.
+ */
+struct RecordedCommand {
+    long micros; // Time the command was read, since the session started
+    string payload; // CommandCodec payload
+
+    RecordedCommand();
+};
+
+/**
+ * Records an interactive session (every line WareHouse::start reads) into a compact file, to be replayed later
+ * as a benchmark by warehouse_replay.
+ *
+ * The file starts with RECORDING_MAGIC followed by a record per command: the microseconds since the previous
+ * command and the payload's size as varints, then the command's CommandCodec payload. A step is a single 6 byte
+ * record, so the step boundaries cost next to nothing.
+ */
+class SessionRecorder {
+    public:
+        SessionRecorder(const string &path);
+        void record(const string &command);
+        bool isOpen() const;
+        ~SessionRecorder() = default;
+
+        SessionRecorder(const SessionRecorder &other) = delete;
+        SessionRecorder &operator=(const SessionRecorder &other) = delete;
+
+        static bool load(const string &path, vector<RecordedCommand> &commands);
+
+    private:
+        std::ofstream out;
+        std::chrono::steady_clock::time_point start;
+        long lastMicros;
+        string buffer; // Reused for every record
+};
@@ -0,0 +1,82 @@
+#pragma once
+#include <string>
+#include <vector>
+#include <deque>
+#include <map>
+#include <sstream>
+#include <thread>
+#include <mutex>
+#include <condition_variable>
+using std::string;
+using std::vector;
+using std::deque;
+using std::map;
+
+class WareHouse;
+class SessionRecorder;
+
+/**
+ * Serves the warehouse over a local (unix domain) socket using an epoll event loop.
+ * Any number of clients may connect and send commands in the usual grammar, one per line. The commands are
+ * performed on a simulation thread, in the order in which the lines arrived, and their output is sent back to the
+ * client that sent them. Several commands may be pipelined in a single write, their responses are batched into as
+ * few writes as possible. When a recorder is given, every performed command is recorded before it is performed,
+ * as WareHouse::start does.
+ *
+ * If the warehouse publishes read views, the event loop answers orderStatus, customerStatus and volunteerStatus
+ * from the latest view itself, without waiting for the simulation thread - a long step doesn't hold the queries
+ * back. A client's query is only answered that way once its earlier commands were performed (and published), so
+ * each client still sees its commands in order. Those queries aren't logged, journaled or recorded.
+ */
+class SocketServer {
+    public:
+        SocketServer(WareHouse &wareHouse, const string &path, SessionRecorder *recorder = nullptr);
+        bool run(); // Blocks until the warehouse is closed, false if the socket couldn't be set up
+        ~SocketServer();
+
+        SocketServer(const SocketServer &other) = delete;
+        SocketServer &operator=(const SocketServer &other) = delete;
+
+    private:
+        struct Client {
+            string input;  // Received bytes which aren't a full line yet
+            string output; // Responses which weren't written yet
+            bool waitingOutput; // True while the socket is full and we wait for EPOLLOUT
+            bool hungUp;
+            int performing; // Batches sent to the simulation thread which weren't answered yet
+            Client() : input(), output(), waitingOutput(false), hungUp(false), performing(0) { }
+        };
+        struct Batch {
+            int fd; // The client which sent the commands
+            vector<string> commands; // Performed in order
+            string output;
+            explicit Batch(int fd) : fd(fd), commands(), output() { }
+        };
+
+        WareHouse &wareHouse;
+        const string path;
+        SessionRecorder *recorder; // Not owned, nullptr if the session isn't recorded
+        int listenFd;
+        int epollFd;
+        int wakeFd; // eventfd the simulation thread signals once it performed a batch
+        map<int, Client> clients;
+        std::ostringstream response; // Captures what the actions print, on the simulation thread
+
+        std::thread simulation;
+        std::mutex lock; // Guards the fields below, shared with the simulation thread
+        std::condition_variable submitted;
+        deque<Batch> waiting; // Batches the simulation thread didn't perform yet
+        vector<Batch> performed; // Batches the event loop didn't pick up yet
+        bool closed; // Set once a performed command closed the warehouse
+        bool stopping; // Set by the event loop to stop the simulation thread
+
+        void simulate();
+        void acceptClients();
+        void readClient(int fd, Client &client);
+        bool answerFromView(const string &line, string &output) const;
+        bool collectPerformed();
+        void writeClient(int fd, Client &client);
+        void closeClient(int fd);
+        void stopSimulation();
+        void watch(int fd, unsigned int events, int operation);
+};
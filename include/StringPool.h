@@ -0,0 +1,35 @@
+#pragma once
+#include <string>
+#include <deque>
+#include <unordered_map>
+#include <cstdint>
+#include "MemoryAccounting.h"
+using std::string;
+
+/**
+ * Interns the names of customers and volunteers, entities keep a 32-bit id instead of their own copy.
+ * Names are only ever added, so an id stays valid for the pool's lifetime and the pool can be shared (through a
+ * shared_ptr) by a warehouse, its backups and its actions - copying a warehouse never copies a name.
+ * Only the simulation thread interns names. The pool is charged to its own MemoryContext, not to the warehouses
+ * sharing it.
+ */
+class StringPool {
+    public:
+        StringPool();
+        StringPool(const StringPool &other) = delete; // Shared, never copied
+        StringPool &operator=(const StringPool &other) = delete;
+        ~StringPool();
+
+        uint32_t intern(const string &str); // Id of the string, added if it's new
+        string get(uint32_t id) const;
+        uint32_t size() const;
+        MemoryUsage getMemoryUsage() const;
+
+    private:
+        typedef std::basic_string<char, std::char_traits<char>, AccountedAllocator<char, MemoryCategory::Names>> Name;
+
+        MemoryContext *memory; // Charged with the strings and ids
+        std::deque<Name, AccountedAllocator<Name, MemoryCategory::Names>> strings; // Indexed by id, a deque never moves its strings
+        std::unordered_multimap<size_t, uint32_t, std::hash<size_t>, std::equal_to<size_t>,
+            AccountedAllocator<std::pair<const size_t, uint32_t>, MemoryCategory::Names>> ids; // String hash -> id, keeps no copy of the string
+};
@@ -1,20 +1,38 @@
     #pragma once
 #include <string>
 #include <vector>
+#include <cstdint>
+#include <atomic>
 #include "Order.h"
+#include "ServiceTime.h"
+#include "MemoryAccounting.h"
 using std::string;
 using std::vector;
 
 #define NO_ORDER -1
 
+typedef AccountedVector<int, MemoryCategory::Volunteers> VolunteerOrderIds;
+
+/**
+ * A volunteer may be owned by several warehouses at once: forks share their warehouse's volunteers and a
+ * warehouse clones a shared volunteer only before changing it (see WareHouse::ownVolunteer). A shared volunteer
+ * is never changed, the owners only read it.
+ */
 class Volunteer {
     public:
-        Volunteer(int id, const string &name);
+        Volunteer(int id, uint32_t nameId);
+        Volunteer(const Volunteer &other); // The copy has a single owner
+        Volunteer &operator=(const Volunteer &other) = delete;
         int getId() const;
-        const string &getName() const;
+        uint32_t getNameId() const; // Id of the name in the warehouse's StringPool
         int getActiveOrderId() const;
         int getCompletedOrderId() const;
+        const VolunteerOrderIds &getFinishedOrderIds() const; // Orders finished by the last call to step()
         bool isBusy() const; // Signal whether the volunteer is currently processing an order    
+        virtual bool isLoading() const; // Signal whether the volunteer is busy but may still take orders this step
+        const ServiceTime &getServiceTime() const;
+        void setServiceTime(const ServiceTime &serviceTime);
+        void setServiceSeed(unsigned long long seed);
         virtual bool hasOrdersLeft() const = 0; // Signal whether the volunteer didn't reach orders limit,Always true for CollectorVolunteer and DriverVolunteer
         virtual bool canTakeOrder(const Order &order) const = 0; // Signal if the volunteer can take the order.      
         virtual void acceptOrder(const Order &order) = 0; // Prepare for new order(Reset activeOrderId,TimeLeft,DistanceLeft,OrdersLeft depends on the volunteer type)
@@ -25,6 +43,13 @@ class Volunteer {
         virtual Volunteer* clone() const = 0; //Return a copy of the volunteer
 
         virtual ~Volunteer() = default;
+
+        Volunteer *share(); // Adds an owner, returns this
+        bool isShared() const;
+        static void release(Volunteer *volunteer); // Removes an owner, the last one deletes the volunteer
+
+        static void *operator new(size_t size); // Accounted in MemoryCategory::Volunteers
+        static void operator delete(void *memory, size_t size);
         /**
          * Used in SimulateStep::step.
          * A visitor design pattern to improve runtime-dynamic dispatch of free volunteers
@@ -36,10 +61,13 @@ class Volunteer {
     protected:
         int completedOrderId; //Initialized to NO_ORDER if no order has been completed yet
         int activeOrderId; //Initialized to NO_ORDER if no order is being processed
+        VolunteerOrderIds finishedOrderIds; //Orders finished by the last step, completedOrderId is the last of them
+        ServiceTime serviceTime; //Samples the time each order takes, fixed unless configured otherwise
     
     private:
         const int id;
-        const string name;
+        const uint32_t nameId;
+        std::atomic<int> owners; // Warehouses holding the volunteer
 
 };
 
@@ -47,11 +75,14 @@ class Volunteer {
 class CollectorVolunteer: public Volunteer {
 
     public:
-        CollectorVolunteer(int id, string name, int coolDown);
+        CollectorVolunteer(int id, uint32_t nameId, int coolDown, int batchSize = 1, int extraCoolDown = 0);
         CollectorVolunteer *clone() const override;
         void step() override;
         int getCoolDown() const;
         int getTimeLeft() const;
+        int getBatchSize() const;
+        int getExtraCoolDown() const;
+        bool isLoading() const override; // Signal if the cycle didn't start yet and the batch isn't full
         bool decreaseCoolDown();//Decrease timeLeft by 1,return true if timeLeft=0,false otherwise
         bool hasOrdersLeft() const override;
         bool canTakeOrder(const Order &order) const override;
@@ -64,14 +95,19 @@ class CollectorVolunteer: public Volunteer {
     private:
         const int coolDown; // The time it takes the volunteer to process an order
         int timeLeft; // Time left until the volunteer finishes his current order
+        const int batchSize; // The number of orders the volunteer can pick in one cycle
+        const int extraCoolDown; // The time each order beyond the first adds to the cycle
+        int cycleLength; // The time the current cycle takes, coolDown plus the extra orders' time
+        VolunteerOrderIds batchOrderIds; // The orders picked in the current cycle, activeOrderId is the first
 };
 
 class LimitedCollectorVolunteer: public CollectorVolunteer {
 
     public:
-        LimitedCollectorVolunteer(int id, string name, int coolDown ,int maxOrders);
+        LimitedCollectorVolunteer(int id, uint32_t nameId, int coolDown ,int maxOrders, int batchSize = 1, int extraCoolDown = 0);
         LimitedCollectorVolunteer *clone() const override;
         bool hasOrdersLeft() const override;
+        bool isLoading() const override;
         bool canTakeOrder(const Order &order) const override;
         void acceptOrder(const Order &order) override;
 
@@ -89,17 +125,19 @@ class LimitedCollectorVolunteer: public CollectorVolunteer {
 class DriverVolunteer: public Volunteer {
 
     public:
-        DriverVolunteer(int id, string name, int maxDistance, int distancePerStep);
+        DriverVolunteer(int id, uint32_t nameId, int maxDistance, int distancePerStep, int capacity = 1);
         DriverVolunteer *clone() const override;
 
         int getDistanceLeft() const;
         int getMaxDistance() const;
         int getDistancePerStep() const;  
+        int getCapacity() const;
+        bool isLoading() const override; // Signal if the trip didn't start yet and there's room for more orders
         bool decreaseDistanceLeft(); //Decrease distanceLeft by distancePerStep,return true if distanceLeft<=0,false otherwise
         bool hasOrdersLeft() const override;
-        bool canTakeOrder(const Order &order) const override; // Signal if the volunteer is not busy and the order is within the maxDistance
-        void acceptOrder(const Order &order) override; // Assign distanceLeft to order's distance
-        void step() override; // Decrease distanceLeft by distancePerStep
+        bool canTakeOrder(const Order &order) const override; // Signal if the volunteer is not busy (or loading) and the order is within the maxDistance
+        void acceptOrder(const Order &order) override; // Add the order to the trip, the trip's length is its farthest order's distance
+        void step() override; // Decrease distanceLeft by distancePerStep, drop off the orders that were reached
         string toString() const override;
 
         ~DriverVolunteer() override = default;
@@ -109,17 +147,22 @@ class DriverVolunteer: public Volunteer {
         const int maxDistance; // The maximum distance of ANY order the volunteer can take
         const int distancePerStep; // The distance the volunteer does in one step
         int distanceLeft; // Distance left until the volunteer finishes his current order
+        const int capacity; // The number of orders the volunteer can carry in one trip
+        int tripLength; // The distance of the farthest order in the current trip (activeOrderId)
+        VolunteerOrderIds tripOrderIds; // The orders still carried in the current trip, activeOrderId included
+        VolunteerOrderIds tripDistances; // Their distances
 };
 
 class LimitedDriverVolunteer: public DriverVolunteer {
 
     public:
-        LimitedDriverVolunteer(int id, const string &name, int maxDistance, int distancePerStep,int maxOrders);
+        LimitedDriverVolunteer(int id, uint32_t nameId, int maxDistance, int distancePerStep,int maxOrders, int capacity = 1);
         LimitedDriverVolunteer *clone() const override;
         int getMaxOrders() const;
         int getNumOrdersLeft() const;
         bool hasOrdersLeft() const override;
-        bool canTakeOrder(const Order &order) const override; // Signal if the volunteer is not busy, the order is within the maxDistance.
+        bool isLoading() const override;
+        bool canTakeOrder(const Order &order) const override; // Signal if the volunteer is not busy (or loading), the order is within the maxDistance.
         void acceptOrder(const Order &order) override; // Assign distanceLeft to order's distance and decrease ordersLeft
         string toString() const override;
 
@@ -6,10 +6,24 @@ using namespace std;
 #include "Order.h"
 #include "Customer.h"
 #include "ActionFactory.h"
+#include "OrderTracer.h"
+#include "OrderQueue.h"
+#include "ReadView.h"
+#include "Dispatch.h"
+#include "Scheduler.h"
+#include "OrderPool.h"
+#include "MemoryAccounting.h"
+#include "ActionLog.h"
+#include "OrderIndex.h"
+#include "OrderHistory.h"
+#include "StringPool.h"
+#include "Journal.h"
+#include "SessionRecorder.h"
 
 class BaseAction;
 class ActionFactory;
 class Volunteer;
+class ScenarioRunner;
 
 
 // Warehouse responsible for Volunteers, Customers Actions, and Orders.
@@ -17,47 +31,114 @@ class Volunteer;
 class WareHouse {
 
     public:
+        WareHouse();
         WareHouse(const string &configFilePath);
-        void start();
-        void addOrder(Order* order);
+        void start(SessionRecorder *recorder = nullptr);
+        void execute(const string &input);
+        void perform(BaseAction *action);
+        Order &addOrder(const Order &order);
+        int addOrders(const vector<int> &customerIds, int count);
+        bool placeOrder(int customerId);
+        bool placeGeneratedOrder(int customerId);
         void addAction(BaseAction* action);
-        Customer &getCustomer(int customerId) const;
+        const Customer &getCustomer(int customerId) const;
         Volunteer &getVolunteer(int volunteerId) const;
         Order &getOrder(int orderId) const;
-        const vector<BaseAction*> &getActions() const;
+        const Customer *findCustomer(int customerId) const;
+        OrderIdRange getCustomerOrderIds(int customerId) const;
+        Volunteer *findVolunteer(int volunteerId) const;
+        Order *findOrder(int orderId) const;
+        const ActionLog &getActions() const;
         void close();
         void open();
+        bool isOpened() const;
 
         // Student defined functions and variables:
         int addVolunteer(Volunteer* volunteer);
         int addCustomer(int type, const string &name, int locationDistance, int maxOrders);
+        int addCustomer(int type, uint32_t nameId, int locationDistance, int maxOrders);
+        const shared_ptr<StringPool> &getNames() const;
+        void reserveCustomers(unsigned long count);
   
         ~WareHouse(); //Destructor
         int getCustomerCount() const;
         int getVolunteerCount() const;
         int getOrderCount() const;
-        const vector<Order*> &getPendingOrders() const;
-        const vector<Order*> &getInProcessOrders() const;
-        const vector<Order*> &getCompletedOrders() const;
+        unsigned long getOrdersMemoryUsage() const;
+        MemoryUsage getMemoryUsage() const;
+        const PendingOrderList &getPendingOrders() const;
+        const InProcessOrderList &getInProcessOrders() const;
+        const CompletedOrderList &getCompletedOrders() const;
+        vector<int> queryOrders(const OrderQuery &query, int &matched) const;
+        bool getOrderAt(int orderId, int step, Order &past) const;
+        bool setLogRetention(LogRetention retention, unsigned long limit, const string &spillPath);
         void step();
         void advanceOrder(int orderId);
+        int getStepCount() const;
+        void setTracer(OrderTracer *tracer);
+        void setJournal(Journal *journal);
+        void submitOrder(int customerId);
+        int drainSubmittedOrders();
+        void enableReadViews();
+        void refreshReadView();
+        void setDispatchPolicy(DispatchPolicy policy);
+        DispatchPolicy getDispatchPolicy() const;
+        void setSeed(unsigned long long seed);
+        unsigned long long getSeed() const;
+        void setScheduler(Scheduler *scheduler);
+        const Scheduler &getScheduler() const;
+        ScenarioRunner &getScenarioRunner();
+        vector<int> getLatencies(CustomerType type) const;
+        shared_ptr<const ReadView> getReadView() const;
         WareHouse(const WareHouse &other);
         WareHouse(WareHouse &&other) noexcept;
         WareHouse& operator=(const WareHouse &other);
         WareHouse& operator=(WareHouse &&other) noexcept;
+        WareHouse fork() const;
 
     private:
+        MemoryContext *memory; //Charged with what this warehouse allocates, see MemoryScope
         bool isOpen;
-        vector<BaseAction*> actionsLog;
-        vector<Volunteer*> volunteers;
-        vector<Order*> pendingOrders;
-        vector<Order*> inProcessOrders;
-        vector<Order*> completedOrders;
-        vector<Customer*> customers;
+        ActionLog actionsLog;
+        VolunteerList volunteers;
+        OrderPool orders; //Owns all the orders, the vectors below point into it
+        PendingOrderList pendingOrders;
+        InProcessOrderList inProcessOrders;
+        CompletedOrderList completedOrders;
+        OrderIndex orderIndex; //Secondary indexes over the orders, updated on every transition
+        OrderHistory history; //Every transition of every order
+        bool tracking; //Whether the order indexes and history are kept, false in forks
+        CustomerTable customers;
         int customerCounter; //For assigning unique customer IDs
         int volunteerCounter; //For assigning unique volunteer IDs
+        shared_ptr<StringPool> names; //Customers' and volunteers' names, shared with backups of this warehouse
 
         ActionFactory actionFactory;
         int orderCounter; //For assigning unique order IDs
+        int stepCount; //Steps performed so far
+        OrderTracer *tracer; //Not owned, nullptr when tracing is disabled
+        Journal *journal; //Not owned, nullptr when journaling is disabled
+        const BaseAction *stepCommand; //The running step or generate command while journaling, nullptr otherwise
+        int unjournaledSteps; //Steps the running command performed which aren't journaled yet
+        vector<int> unjournaledOrders; //Customers of the orders the running generate placed since, -n for n steps
+        bool stepsSplit; //Whether orders were drained between the running step command's steps
+        OrderQueue submittedOrders; //Orders submitted by other threads, drained at each step
+        bool publishingViews; //Whether a read view is published after each step
+        shared_ptr<const ReadView> readView; //Only accessed through atomic_load/atomic_store
+        vector<const Order*> changedOrders; //Orders changed since the last published view
+        vector<int> changedCustomers; //Ids of the customers changed since the last published view
+        vector<int> changedVolunteers; //Ids of the volunteers changed since the last published view
+        DispatchPolicy dispatchPolicy;
+        unsigned long long seed; //The volunteers' service times are sampled from it
+        Scheduler *scheduler; //Decides which pending orders are served first, owned by the warehouse
+        ScenarioRunner *scenarioRunner; //Runs the what-if scenarios, made for the first one, owned by the warehouse
+        WareHouse(const WareHouse &other, const vector<int> &liveOrderIds);
         void freeResources();
+        void performAndJournal(BaseAction *action, const string &command);
+        void journalSteps();
+        void publishReadView(bool rebuild);
+        Volunteer *ownVolunteer(Volunteer *volunteer);
+        Volunteer *assignCollector(Order *order, Volunteer *collector);
+        Volunteer *assignDriver(Order *order, Volunteer *driver);
+        void matchDrivers(vector<Volunteer*> &freeDrivers);
 };
\ No newline at end of file
@@ -0,0 +1,118 @@
+#pragma once
+#include <string>
+#include <vector>
+#include <memory>
+#include "WareHouse.h"
+#include "Action.h"
+using std::string;
+using std::vector;
+using std::shared_ptr;
+
+/**
+ * An order as the engine reports it.
+ */
+struct OrderInfo {
+    int id;
+    int customerId;
+    int distance;
+    OrderStatus status;
+    int collectorId; // NO_VOLUNTEER until a collector is assigned
+    int driverId; // NO_VOLUNTEER until a driver is assigned
+    int createdStep;
+    int completedStep; // NO_STEP until the order is completed
+
+    OrderInfo();
+};
+
+/**
+ * A customer as the engine reports it.
+ */
+struct CustomerInfo {
+    int id;
+    string name;
+    CustomerType type;
+    int distance;
+    int maxOrders;
+    vector<int> orderIds; // Oldest first
+
+    CustomerInfo();
+};
+
+/**
+ * A volunteer as the engine reports it.
+ */
+struct VolunteerInfo {
+    int id;
+    string name;
+    bool busy;
+    bool hasOrdersLeft; // False once a limited volunteer took its max orders
+    int activeOrderId; // NO_ORDER if not busy
+    int completedOrderId; // NO_ORDER if no order was completed yet
+
+    VolunteerInfo();
+};
+
+/**
+ * A copy of the whole state of an engine's warehouse, see WarehouseEngine::snapshot. Immutable, copies of a
+ * snapshot share the same state. A default constructed snapshot is empty.
+ */
+class WarehouseSnapshot {
+    public:
+        WarehouseSnapshot();
+        bool empty() const;
+        int getStepCount() const;
+        int getOrderCount() const;
+
+    private:
+        friend class WarehouseEngine;
+        explicit WarehouseSnapshot(const shared_ptr<const WareHouse> &state);
+
+        shared_ptr<const WareHouse> state;
+};
+
+/**
+ * The warehouse as a library: a typed API over a single warehouse for harnesses that embed the simulation.
+ * Nothing is parsed or printed - the calls take and return plain values, failures are reported through the
+ * return value (-1 ids, false). The calls aren't logged or journaled, and the engine must only be used by one
+ * thread at a time - except submitOrder and getReadView, which any thread may call while another one steps the
+ * engine.
+ *
+ * The text commands (WareHouse::execute and the warehouse binary) are a front-end over the same warehouse,
+ * getWareHouse() gives access to whatever the typed API doesn't cover.
+ */
+class WarehouseEngine {
+    public:
+        WarehouseEngine(); // An empty open warehouse
+        explicit WarehouseEngine(const string &configFilePath); // Reads the config as the warehouse binary does
+
+        int addCustomer(const string &name, CustomerType type, int distance, int maxOrders);
+        int addCollector(const string &name, int coolDown, int maxOrders = NOT_LIMITED,
+                         const VolunteerOptions &options = VolunteerOptions());
+        int addDriver(const string &name, int maxDistance, int distancePerStep, int maxOrders = NOT_LIMITED,
+                      const VolunteerOptions &options = VolunteerOptions());
+        int addOrder(int customerId);
+        void submitOrder(int customerId); // Thread safe, placed at the next step
+        void step(int steps = 1);
+
+        int getStepCount() const;
+        int getCustomerCount() const;
+        int getVolunteerCount() const;
+        int getOrderCount() const;
+        bool getOrder(int orderId, OrderInfo &info) const;
+        bool getCustomer(int customerId, CustomerInfo &info) const;
+        bool getVolunteer(int volunteerId, VolunteerInfo &info) const;
+
+        void enableReadViews();
+        void refreshReadView();
+        shared_ptr<const ReadView> getReadView() const; // Thread safe
+
+        WarehouseSnapshot snapshot() const;
+        bool restore(const WarehouseSnapshot &snapshot);
+
+        WareHouse &getWareHouse();
+
+    private:
+        WareHouse wareHouse;
+
+        int addVolunteer(AddVolunteer &action);
+};
@@ -0,0 +1,66 @@
+#pragma once
+#include <string>
+#include <vector>
+#include <ostream>
+#include "Dispatch.h"
+#include "ServiceTime.h"
+using std::string;
+using std::vector;
+
+enum class ArrivalPattern {
+    Uniform, // The same amount of orders arrives every step
+    Burst,   // Orders arrive in bursts every few steps
+    Poisson, // The amount of orders per step is Poisson distributed
+};
+
+/**
+ * Describes a synthetic workload, use WorkloadSpec::forOrders for sensible defaults.
+ */
+struct WorkloadSpec {
+    unsigned long long seed;
+    long orders;          // Total amount of orders placed by the command script
+    int customers;
+    int collectors;
+    int drivers;
+    int driverCapacity;   // Orders each driver carries per trip
+    int collectorBatch;   // Orders each collector picks per cycle
+    int ordersPerStep;    // Mean arrival rate
+    int maxDistance;      // Customers are placed in [1, maxDistance]
+    int burstPeriod;      // Only used by ArrivalPattern::Burst
+    int drainSteps;       // Steps appended after the last arrival so the backlog gets processed
+    ArrivalPattern pattern;
+    DispatchPolicy dispatch;
+    ServiceDistribution service; // Service times of all the volunteers, sampled from the seed
+
+    static WorkloadSpec forOrders(long orders, unsigned long long seed);
+};
+
+/**
+ * Deterministic (seeded) generator of warehouse config files and command scripts.
+ * The same spec always produces byte-identical output on every platform, since it
+ * doesn't rely on the standard library distributions.
+ */
+class WorkloadGenerator {
+    public:
+        WorkloadGenerator(const WorkloadSpec &spec);
+        void writeConfig(std::ostream &out);
+        void writeCommands(std::ostream &out);
+        const WorkloadSpec &getSpec() const;
+
+        static bool parsePattern(const string &name, ArrivalPattern &pattern);
+        static string patternName(ArrivalPattern pattern);
+
+    private:
+        const WorkloadSpec spec;
+        unsigned long long state;
+        vector<int> ordersLeft; // Orders each generated customer can still place
+        int maxOrdersPerCustomer;
+
+        void reseed(unsigned long long salt);
+        unsigned long long next();
+        int nextInt(int low, int high); // Uniform in [low, high]
+        double nextDouble(); // Uniform in [0, 1)
+        long arrivalsAt(long step);
+        int pickCustomer();
+        void writeService(std::ostream &out) const;
+};
@@ -1,8 +1,14 @@
 #include <iostream>
+#include <fstream>
+#include <sstream>
+#include <algorithm>
 #include "../include/Action.h"
 #include "../include/Volunteer.h"
+#include "../include/CommandCodec.h"
 
 
+WareHouse* backup = nullptr;
+
 // Constructors, destructors, and method implementations for BaseAction
 /**
  * Status is initialized as error until act is done.
@@ -13,6 +19,20 @@ errorMsg("Not yet acted"),
 status(ActionStatus::ERROR)
 { }
 
+/**
+ * Charged to the current context, see MemoryScope.
+ */
+void *BaseAction::operator new(size_t size) {
+    return MemoryAccounting::allocate(MemoryCategory::Actions, size, 1);
+}
+
+/**
+ * Credits the context the action was charged to, its size is recorded with the allocation.
+ */
+void BaseAction::operator delete(void *memory, size_t) {
+    MemoryAccounting::deallocate(memory, MemoryCategory::Actions, 1);
+}
+
 /**
  * returns the status.
  * @return status, COMPLETED = 0 if completed, ERROR = 1 if there was an error
@@ -45,6 +65,15 @@ string BaseAction::getErrorMsg() const {
     return errorMsg;
 }
 
+/**
+ * Appends the action's journal record payload, the command it was created from by default.
+ * @param command the command the action was created from, as given to WareHouse::execute.
+ * @param payload buffer to append the payload to.
+ */
+void BaseAction::encode(const string &command, string &payload) const {
+    CommandCodec::encode(command, payload);
+}
+
 /**
  * Gets a string version of the action status.
  * @return string "COMPLETED" if status is completed, or "ERROR" if status is error.
@@ -102,25 +131,12 @@ AddOrder::AddOrder(int id) : BaseAction(), customerId(id) { }
  * @param wareHouse - wareHouse to add the order to.
  */
 void AddOrder::act(WareHouse &wareHouse) {
-    try {
-        Customer &customer = wareHouse.getCustomer(customerId);
-        if (!customer.canMakeOrder()) {
-            error("Cannot place this order");
-            std::cout << getErrorMsg() << std::endl;
-            return;
-        }
-        int customerDistance = customer.getCustomerDistance();
-        int orderID = wareHouse.getOrderCount();
-        Order* order = new Order(orderID ,customerId, customerDistance);
-        customer.addOrder(orderID);
-        wareHouse.addOrder(order);
-        complete();
-    }
-    // Customer doesn't exist
-    catch (const std::exception&) {
+    if (!wareHouse.placeOrder(customerId)) { // The customer doesn't exist or reached its max orders
         error("Cannot place this order");
         std::cout << getErrorMsg() << std::endl;
+        return;
     }
+    complete();
 }
 
 /**
@@ -134,16 +150,127 @@ AddOrder* AddOrder::clone() const {
     return new AddOrder(*this);
 }
 
+// Implementations for AddOrders
+/**
+ * Creates a new AddOrders action placing several orders for the same customer.
+ * @param customerId - id of the customer making the orders.
+ * @param count - amount of orders to place.
+ */
+AddOrders::AddOrders(int customerId, int count) :
+    BaseAction(), customerIds(1, customerId), count(count), listed(false) { }
+
+/**
+ * Creates a new AddOrders action placing one order for each of the given customers.
+ * @param customerIds - the customers making the orders, in order (a customer may appear more than once).
+ */
+AddOrders::AddOrders(const vector<int> &customerIds) :
+    BaseAction(), customerIds(customerIds), count(1), listed(true) { }
+
+/**
+ * Places all the orders at once and prints how many were placed and how many were rejected, an order is
+ * rejected for the same reasons AddOrder fails. The action errors if any of the orders was rejected.
+ * @param wareHouse - wareHouse to add the orders to.
+ */
+void AddOrders::act(WareHouse &wareHouse) {
+    int placed = wareHouse.addOrders(customerIds, count);
+    int rejected = (int) customerIds.size() * count - placed;
+    std::cout << "Orders placed: " << placed << ", rejected: " << rejected << std::endl;
+    if (rejected > 0) {
+        error("Cannot place " + to_string(rejected) + " of the orders");
+        return;
+    }
+    complete();
+}
+
+/**
+ * @return "orders (customer_id) (count) (status)" or "orders (customer_id,customer_id,...) (status)"
+ */
+string AddOrders::toString() const {
+    string str = "orders ";
+    if (listed) {
+        for (unsigned long i = 0; i < customerIds.size(); i++) {
+            str += (i > 0 ? "," : "") + to_string(customerIds[i]);
+        }
+    } else {
+        str += to_string(customerIds[0]) + " " + to_string(count);
+    }
+    return str + " " + getStatusString();
+}
+
+AddOrders* AddOrders::clone() const {
+    return new AddOrders(*this);
+}
+
+// Implementations for GenerateOrders
+/**
+ * Creates a GenerateOrders action, syntax: generate (steps) rate=(orders per step) dist=(poisson/bursty) seed=(seed)
+ * @param rate mean amount of orders arriving per step.
+ */
+GenerateOrders::GenerateOrders(int steps, double rate, ArrivalDistribution distribution, unsigned long long seed) :
+    BaseAction(), steps(steps), rate(rate), distribution(distribution), seed(seed) { }
+
+/**
+ * Performs the steps, each one after placing the orders arriving at it. Every order is placed by a random
+ * customer among those that can still make an order, the same seed always places the same orders.
+ * Prints how many orders were placed and how many arrived after no customer could order anymore.
+ * @param wareHouse - wareHouse to add the orders to.
+ */
+void GenerateOrders::act(WareHouse &wareHouse) {
+    ArrivalProcess arrivals(seed, rate, distribution);
+    vector<int> eligible(wareHouse.getCustomerCount()); // Customers that may still order
+    for (unsigned long i = 0; i < eligible.size(); i++) eligible[i] = i;
+    long placed = 0, rejected = 0;
+    for (int step = 0; step < steps; step++) {
+        long count = arrivals.next();
+        for (long i = 0; i < count; i++) {
+            if (eligible.empty()) { // Every customer reached its max orders, the rest can only be rejected
+                rejected += count - i;
+                break;
+            }
+            bool ordered = false;
+            while (!ordered && !eligible.empty()) {
+                unsigned long picked = arrivals.pick(eligible.size());
+                ordered = wareHouse.placeGeneratedOrder(eligible[picked]);
+                if (!ordered) { // Reached its max orders, never picked again
+                    eligible[picked] = eligible.back();
+                    eligible.pop_back();
+                }
+            }
+            if (ordered) placed++;
+            else rejected++;
+        }
+        wareHouse.step();
+    }
+    std::cout << "Orders placed: " << placed << ", rejected: " << rejected << std::endl;
+    complete();
+}
+
+/**
+ * @return "generate (steps) rate=(rate) dist=(distribution) seed=(seed) (status)"
+ */
+string GenerateOrders::toString() const {
+    std::ostringstream text;
+    text << "generate " << steps << " rate=" << rate << " dist=" << ArrivalProcess::distributionName(distribution)
+         << " seed=" << seed << " " << getStatusString();
+    return text.str();
+}
+
+GenerateOrders* GenerateOrders::clone() const {
+    return new GenerateOrders(*this);
+}
+
 // Implementations for AddCustomer
 /**
  * Creates a AddCustomer action
+ * @param names - the warehouse's names, customerName is interned there.
  * @param customerName
  * @param customerType - assumes it's either "soldier" or "civilian".
  * @param distance - assumes it's a positive number
  * @param maxOrders - assumes it's a positive number
  */
-AddCustomer::AddCustomer (string customerName, string customerType, int distance, int maxOrders)
-        : BaseAction(), customerName(customerName),
+AddCustomer::AddCustomer (const shared_ptr<StringPool> &names, const string &customerName, string customerType,
+                          int distance, int maxOrders)
+        : BaseAction(), names(names), customerNameId(names->intern(customerName)),
         customerType(customerType == "soldier" ? CustomerType::Soldier : CustomerType::Civilian),
         distance(distance), maxOrders(maxOrders) { }
 
@@ -152,7 +279,7 @@ AddCustomer::AddCustomer (string customerName, string customerType, int distance
  * @param wareHouse
  */
 void AddCustomer::act(WareHouse &wareHouse) {
-    wareHouse.addCustomer(customerType == CustomerType::Soldier ? 0 : 1, customerName, distance, maxOrders);
+    wareHouse.addCustomer(customerType == CustomerType::Soldier ? 0 : 1, customerNameId, distance, maxOrders);
     complete();
 }
 
@@ -164,33 +291,130 @@ AddCustomer *AddCustomer::clone() const {
  * @return "customer (customer_name) (customer_type) (customer_distance) (max_orders) (status)"
  */
 string AddCustomer::toString() const {
-    return "customer "+customerName+" "+(customerType == CustomerType::Soldier ? "soldier" : "civilian")+
+    return "customer "+names->get(customerNameId)+" "+(customerType == CustomerType::Soldier ? "soldier" : "civilian")+
     " "+to_string(distance)+" "+to_string(maxOrders)+" "+getStatusString();
 }
 
+// Implementations for AddCustomers
+/**
+ * Creates a AddCustomers action importing customers from a csv file.
+ * @param filePath - csv file with a (customer_name),(customer_type),(customer_distance),(max_orders) row per customer,
+ * empty lines and lines starting with # are skipped.
+ */
+AddCustomers::AddCustomers(const string &filePath) :
+    BaseAction(), filePath(filePath), read(false), opened(false), rows() { }
+
+/**
+ * Creates a AddCustomers action importing rows that were already read from the file, e.g. replayed from the
+ * journal. The file isn't read.
+ * @param opened false if the file couldn't be opened, the action then fails as it did.
+ */
+AddCustomers::AddCustomers(const string &filePath, bool opened, const vector<string> &rows) :
+    BaseAction(), filePath(filePath), read(true), opened(opened), rows(rows) { }
+
+/**
+ * Adds every valid row of the file as a customer and prints how many were added and how many rows were rejected.
+ * The action errors if the file can't be read or any row was rejected.
+ * @param wareHouse
+ */
+void AddCustomers::act(WareHouse &wareHouse) {
+    if (!read) {
+        std::ifstream file(filePath);
+        read = true;
+        opened = file.is_open();
+        string line;
+        while (getline(file, line)) {
+            if (!line.empty() && line.back() == '\r') line.pop_back();
+            if (line.empty() || line[0] == '#') continue;
+            rows.push_back(line);
+        }
+    }
+    if (!opened) {
+        error("Cannot open " + filePath);
+        std::cout << getErrorMsg() << std::endl;
+        return;
+    }
+    wareHouse.reserveCustomers(rows.size());
+
+    int added = 0, rejected = 0;
+    for (const string &row : rows) {
+        vector<string> fields;
+        std::stringstream stream(row);
+        string field;
+        while (getline(stream, field, ',')) fields.push_back(field);
+        int distance, maxOrders;
+        if (fields.size() != 4 || (fields[1] != "soldier" && fields[1] != "civilian") || fields[0].empty() ||
+            !ActionFactory::parseInt(fields[2], distance) || !ActionFactory::parseInt(fields[3], maxOrders) ||
+            distance < 0 || maxOrders < 0) {
+            rejected++;
+            continue;
+        }
+        wareHouse.addCustomer(fields[1] == "soldier" ? 0 : 1, fields[0], distance, maxOrders);
+        added++;
+    }
+    std::cout << "Customers added: " << added << ", rejected: " << rejected << std::endl;
+    if (rejected > 0) {
+        error("Cannot add " + to_string(rejected) + " of the customers");
+        return;
+    }
+    complete();
+}
+
+AddCustomers *AddCustomers::clone() const {
+    return new AddCustomers(*this);
+}
+
+/**
+ * Journals the rows the action read instead of the command, the file may change or be gone by the replay.
+ */
+void AddCustomers::encode(const string &, string &payload) const {
+    CommandCodec::encodeCustomers(filePath, opened, rows, payload);
+}
+
+/**
+ * @return "customers (file_path) (status)"
+ */
+string AddCustomers::toString() const {
+    return "customers "+filePath+" "+getStatusString();
+}
+
 //  Implementations for PrintOrderStatus
 /**
  * This action prints an information on a given order, includes its status, the
  * volunteers that are associated with it and the customer who place it.
  * @param id - order id
+ * @param atStep - prints the order as it was after that many steps, NO_STEP for its current status.
  */
-PrintOrderStatus::PrintOrderStatus(int id) : BaseAction(), orderId(id) { }
+PrintOrderStatus::PrintOrderStatus(int id, int atStep) : BaseAction(), orderId(id), atStep(atStep) { }
 
 /**
  * Finds the order according to the orderId, then prints its toString. Will change it's status to error if
- * the order doesn't exist.
+ * the order doesn't exist (or didn't exist yet at atStep).
  * @param wareHouse
  */
 void PrintOrderStatus::act(WareHouse &wareHouse) {
-    try {
-        Order& order = wareHouse.getOrder(orderId);
-        std::cout << order.toString() << std::endl;
-        complete();
+    if (atStep != NO_STEP) {
+        Order past(orderId, 0, 0); // Set by getOrderAt
+        if (atStep > wareHouse.getStepCount()) {
+            error("Step " + to_string(atStep) + " wasn't performed yet");
+            std::cout << getErrorMsg() << std::endl;
+        } else if (wareHouse.getOrderAt(orderId, atStep, past)) {
+            std::cout << past.toString() << std::endl;
+            complete();
+        } else {
+            error("Order doesn’t exist");
+            std::cout << getErrorMsg() << std::endl;
+        }
+        return;
     }
-    catch (const std::exception& ex) {
+    const Order *order = wareHouse.findOrder(orderId);
+    if (order == nullptr) {
         error("Order doesn’t exist");
         std::cout << getErrorMsg() << std::endl;
+        return;
     }
+    std::cout << order->toString() << std::endl;
+    complete();
 }
 
 PrintOrderStatus *PrintOrderStatus::clone() const {
@@ -198,63 +422,73 @@ PrintOrderStatus *PrintOrderStatus::clone() const {
 }
 
 /**
- * @return "orderStatus (order_id) (status)"
+ * @return "orderStatus (order_id) (@step)(if given) (status)"
  */
 string PrintOrderStatus::toString() const {
-    return "orderStatus "+to_string(orderId)+" "+getStatusString();
+    return "orderStatus "+to_string(orderId)+" "+(atStep == NO_STEP ? "" : "@"+to_string(atStep)+" ")+getStatusString();
 }
 
 /**
  * This action prints all information about a particular customer, includes
  * their ID, their orders status, and how many orders they may still place.
  * @param customerId
+ * @param atStep - prints the customer as it was after that many steps, NO_STEP for its current status.
  */
-PrintCustomerStatus::PrintCustomerStatus(int customerId) : BaseAction(), customerId(customerId) { }
+PrintCustomerStatus::PrintCustomerStatus(int customerId, int atStep) :
+    BaseAction(), customerId(customerId), atStep(atStep) { }
 
 /**
  * Prints the customers id, details of each of their orders and then the amount of orders they can still place.
+ * With atStep only the orders placed by then are printed, with their status at the time.
  * @param wareHouse
  */
 void PrintCustomerStatus::act(WareHouse &wareHouse) {
-    try {
-        Customer& customer = wareHouse.getCustomer(customerId);
-
-        std::cout << "CustomerID: " << customer.getId() << std::endl;
-        // print details for each order associated with the customer
-        for (int orderId : customer.getOrdersIds()) {
-            try {
-                Order& order = wareHouse.getOrder(orderId);
-                std::cout << "OrderID: " << orderId << std::endl;
-                std::cout << "OrderStatus: ";
-                switch (order.getStatus()) {
-                    case OrderStatus::PENDING:
-                        std::cout << "Pending";
-                        break;
-                    case OrderStatus::COLLECTING:
-                        std::cout << "Collecting";
-                        break;
-                    case OrderStatus::DELIVERING:
-                        std::cout << "Delivering";
-                        break;
-                    case OrderStatus::COMPLETED:
-                        std::cout << "Completed";
-                        break;
-                    default: // Only if an error occurs, shouldn't ever happen.
-                        std::cout << "Unknown";
-                }
-                std::cout << std::endl;
-            } catch (const std::exception& ex) {
-                // Should not happen, serious error if it does.
-                std::cout << "Error retrieving order details for OrderID: " << orderId << std::endl;
-            }
-        }
-        // Print the number of orders the customer can still place
-        std::cout << "numOrdersLeft: " << (customer.getMaxOrders() - customer.getNumOrders()) << std::endl;
-        complete();
-    } catch (const std::exception& ex) {
+    if (atStep > wareHouse.getStepCount()) {
+        error("Step " + to_string(atStep) + " wasn't performed yet");
+        std::cout << getErrorMsg() << std::endl;
+        return;
+    }
+    const Customer *customer = wareHouse.findCustomer(customerId);
+    if (customer == nullptr) {
         error("Customer doesn’t exist");
         std::cout << getErrorMsg() << std::endl;
+        return;
+    }
+    std::cout << "CustomerID: " << customer->getId() << std::endl;
+    int placed = 0; // By atStep
+    // print details for each order associated with the customer
+    for (int orderId : wareHouse.getCustomerOrderIds(customerId)) {
+        Order past(orderId, customerId, 0);
+        if (atStep != NO_STEP && !wareHouse.getOrderAt(orderId, atStep, past)) continue; // Placed later
+        const Order *order = atStep == NO_STEP ? wareHouse.findOrder(orderId) : &past;
+        if (order == nullptr) { // Should not happen, serious error if it does.
+            std::cout << "Error retrieving order details for OrderID: " << orderId << std::endl;
+            continue;
+        }
+        placed++;
+        std::cout << "OrderID: " << orderId << std::endl;
+        std::cout << "OrderStatus: ";
+        switch (order->getStatus()) {
+            case OrderStatus::PENDING:
+                std::cout << "Pending";
+                break;
+            case OrderStatus::COLLECTING:
+                std::cout << "Collecting";
+                break;
+            case OrderStatus::DELIVERING:
+                std::cout << "Delivering";
+                break;
+            case OrderStatus::COMPLETED:
+                std::cout << "Completed";
+                break;
+            default: // Only if an error occurs, shouldn't ever happen.
+                std::cout << "Unknown";
+        }
+        std::cout << std::endl;
     }
+    // Print the number of orders the customer can still place
+    std::cout << "numOrdersLeft: " << (customer->getMaxOrders() - (atStep == NO_STEP ? customer->getNumOrders() : placed)) << std::endl;
+    complete();
 }
 
 PrintCustomerStatus *PrintCustomerStatus::clone() const {
@@ -262,10 +496,10 @@ PrintCustomerStatus *PrintCustomerStatus::clone() const {
 }
 
 /**
- * @return "customerStatus (customer_id) (status)"
+ * @return "customerStatus (customer_id) (@step)(if given) (status)"
  */
 string PrintCustomerStatus::toString() const {
-    return "customerStatus "+to_string(customerId)+" "+getStatusString();
+    return "customerStatus "+to_string(customerId)+" "+(atStep == NO_STEP ? "" : "@"+to_string(atStep)+" ")+getStatusString();
 }
 
 
@@ -283,15 +517,14 @@ PrintVolunteerStatus::PrintVolunteerStatus(int id) : BaseAction(), VolunteerId(i
  * @param wareHouse
  */
 void PrintVolunteerStatus::act(WareHouse &wareHouse) {
-    try {
-        Volunteer& volunteer = wareHouse.getVolunteer(VolunteerId);
-        std::cout << volunteer.toString() << std::endl;
-        complete();
-    }
-    catch (const std::exception& ex) {
+    const Volunteer *volunteer = wareHouse.findVolunteer(VolunteerId);
+    if (volunteer == nullptr) {
         error("Volunteer doesn’t exist");
         std::cout << getErrorMsg() << std::endl;
+        return;
     }
+    std::cout << volunteer->toString() << std::endl;
+    complete();
 }
 
 PrintVolunteerStatus *PrintVolunteerStatus::clone() const {
@@ -310,17 +543,26 @@ string PrintVolunteerStatus::toString() const {
  * Prints all the actions that were performed by the user (excluding current log action),
  * from the first action to the last action.
  */
-PrintActionsLog::PrintActionsLog() : BaseAction() { }
+/**
+ * @param from - the first entry printed, ignored if tail.
+ * @param count - amount of entries printed, LOG_ALL for all of them.
+ * @param tail - prints the last count entries.
+ */
+PrintActionsLog::PrintActionsLog(long from, long count, bool tail) :
+    BaseAction(), from(from), count(count), tail(tail) { }
 
 /**
  * Prints each of the actions up to this action not including in order with the following syntax:
  * (action_n_name) (action_n_args) (action_n_status)
+ * Only the requested slice of the log is read, entries the log's retention dropped aren't printed.
  * @param wareHouse
  */
 void PrintActionsLog::act(WareHouse &wareHouse) {
-    const vector<BaseAction*>& actions = wareHouse.getActions();
-    for (const BaseAction* action : actions) {
-        std::cout << action->toString() << std::endl;
+    const ActionLog &log = wareHouse.getActions();
+    if (tail) {
+        log.print(std::max(0L, log.size() - count), count, std::cout);
+    } else {
+        log.print(from, count, std::cout);
     }
     complete();
 }
@@ -330,10 +572,16 @@ PrintActionsLog *PrintActionsLog::clone() const {
 }
 
 /**
- * @return log (status)
+ * @return "log (--tail count / --from from --count count)(if given) (status)"
  */
 string PrintActionsLog::toString() const {
-    return "log "+getStatusString();
+    string slice;
+    if (tail) {
+        slice = "--tail " + to_string(count) + " ";
+    } else if (from != 0 || count != LOG_ALL) {
+        slice = "--from " + to_string(from) + " " + (count == LOG_ALL ? "" : "--count " + to_string(count) + " ");
+    }
+    return "log "+slice+getStatusString();
 }
 
 
@@ -476,22 +724,35 @@ string RestoreWareHouse::toString() const {
  *  These actions should not be added to the actionlog ever.
 */
 
+/**
+ * Options of a volunteer that handles a single order at a time.
+ */
+VolunteerOptions::VolunteerOptions() :
+    capacity(1),
+    batchSize(1),
+    extraCoolDown(0),
+    service(ServiceDistribution::Fixed),
+    spread(DEFAULT_SERVICE_SPREAD)
+{ }
+
 /**
  * Creates a AddVolunteer action for adding a volunteer that's a collector,
  * if it's not a limited driver, set the maxOrders field to -1
  *
  * THIS ACTION SHOULD NOT BE ADDED TO THE ACTIONLOG.
- * @param name
+ * @param nameId - id of the volunteer's name in the warehouse's StringPool.
  * @param coolDown
  * @param maxOrders - default -1, if it's limited add here.
+ * @param options - batch picking options, the defaults pick one order per cycle.
  */
-AddVolunteer::AddVolunteer(string name, int coolDown, int maxOrders) :
+AddVolunteer::AddVolunteer(uint32_t nameId, int coolDown, int maxOrders, const VolunteerOptions &options) :
     BaseAction(),
-    name(name),
+    nameId(nameId),
     cooldown(coolDown),
     maxDistance(-1),
     distance_per_step(-1),
     maxOrders(maxOrders),
+    options(options),
     type(VolunteerType::Collector)
 { }
 
@@ -501,18 +762,21 @@ AddVolunteer::AddVolunteer(string name, int coolDown, int maxOrders) :
  * if it's not a limited driver, set the maxOrders field to -1
  *
  * THIS ACTION SHOULD NOT BE ADDED TO THE ACTIONLOG.
- * @param name
+ * @param nameId - id of the volunteer's name in the warehouse's StringPool.
  * @param maxDistance
  * @param distance_per_step
  * @param maxOrders - default -1, if it's limited add here.
+ * @param options - trip options, the defaults carry one order per trip.
  */
-AddVolunteer::AddVolunteer(string name, int maxDistance, int distance_per_step, int maxOrders) :
+AddVolunteer::AddVolunteer(uint32_t nameId, int maxDistance, int distance_per_step, int maxOrders,
+                           const VolunteerOptions &options) :
     BaseAction(),
-    name(name),
+    nameId(nameId),
     cooldown(-1),
     maxDistance(maxDistance),
     distance_per_step(distance_per_step),
     maxOrders(maxOrders),
+    options(options),
     type(VolunteerType::Driver) { }
 
 
@@ -522,27 +786,33 @@ AddVolunteer::AddVolunteer(string name, int maxDistance, int distance_per_step,
  * @param wareHouse
  */
 void AddVolunteer::act(WareHouse &wareHouse) {
-    Volunteer* volunteer;
+    Volunteer* volunteer = nullptr;
     int id = wareHouse.getVolunteerCount();
     // If given an incorrect maxOrders
-    if (!(maxOrders==-1||maxOrders>0))
+    if (!(maxOrders==-1||maxOrders>0) || options.capacity < 1 || options.batchSize < 1 || options.extraCoolDown < 0 ||
+        options.spread < 0 || options.spread > 100)
         return;
     switch(type){
         case VolunteerType::Collector: {
             if (maxOrders == -1)
-                volunteer = new CollectorVolunteer(id, name, cooldown);
+                volunteer = new CollectorVolunteer(id, nameId, cooldown, options.batchSize, options.extraCoolDown);
             else
-                volunteer = new LimitedCollectorVolunteer(id, name, cooldown, maxOrders);
+                volunteer = new LimitedCollectorVolunteer(id, nameId, cooldown, maxOrders, options.batchSize,
+                                                          options.extraCoolDown);
             break;
         }
         case VolunteerType::Driver: {
             if (maxOrders == -1)
-                volunteer = new DriverVolunteer(id, name, maxDistance, distance_per_step);
+                volunteer = new DriverVolunteer(id, nameId, maxDistance, distance_per_step, options.capacity);
             else
-                volunteer = new LimitedDriverVolunteer(id, name, maxDistance, distance_per_step, maxOrders);
+                volunteer = new LimitedDriverVolunteer(id, nameId, maxDistance, distance_per_step, maxOrders,
+                                                       options.capacity);
             break;
         }
+        default:
+            return;
     }
+    volunteer->setServiceTime(ServiceTime(options.service, options.spread));
     wareHouse.addVolunteer(volunteer);
     complete();
 }
@@ -552,7 +822,8 @@ AddVolunteer *AddVolunteer::clone() const {
 }
 
 /**
- * @return "volunteer (volunteer_role) (volunteer_coolDown)/(volunteer_maxDistance) (distance_per_step)(for drivers only) (volunteer_maxOrders)(if limited)"
+ * @return "volunteer (volunteer_role) (volunteer_coolDown)/(volunteer_maxDistance) (distance_per_step)(for drivers only) (volunteer_maxOrders)(if limited)
+ * (capacity=k)(if not 1) (batch=k)(if not 1) (extra_cooldown=t)(if not 0) (service=d)(if not fixed) (spread=p)(if not 50)"
  */
 string AddVolunteer::toString() const {
     string str = "volunteer ";
@@ -568,8 +839,302 @@ string AddVolunteer::toString() const {
     }
     if (maxOrders!=-1)
         str += " "+to_string(maxOrders);
+    if (options.capacity!=1)
+        str += " capacity="+to_string(options.capacity);
+    if (options.batchSize!=1)
+        str += " batch="+to_string(options.batchSize);
+    if (options.extraCoolDown!=0)
+        str += " extra_cooldown="+to_string(options.extraCoolDown);
+    if (options.service!=ServiceDistribution::Fixed)
+        str += " service="+ServiceTime::distributionName(options.service);
+    if (options.service==ServiceDistribution::Uniform && options.spread!=DEFAULT_SERVICE_SPREAD)
+        str += " spread="+to_string(options.spread);
     return str;
 }
 
+/*  Implementations for SetDispatchPolicy - like AddVolunteer this action is only used by the config file.
+ */
+
+/**
+ * Creates a SetDispatchPolicy action, config file syntax: dispatch (greedy/matching)
+ * @param policy how free drivers are assigned to orders awaiting a driver.
+ */
+SetDispatchPolicy::SetDispatchPolicy(DispatchPolicy policy) : BaseAction(), policy(policy) { }
+
+void SetDispatchPolicy::act(WareHouse &wareHouse) {
+    wareHouse.setDispatchPolicy(policy);
+    complete();
+}
+
+SetDispatchPolicy *SetDispatchPolicy::clone() const {
+    return new SetDispatchPolicy(*this);
+}
+
+/**
+ * @return "dispatch (greedy/matching)"
+ */
+string SetDispatchPolicy::toString() const {
+    return string("dispatch ") + (policy == DispatchPolicy::Matching ? "matching" : "greedy");
+}
+
+/*  Implementations for SetSeed - like AddVolunteer this action is only used by the config file.
+ */
+
+/**
+ * Creates a SetSeed action, config file syntax: seed (seed)
+ * @param seed the seed the volunteers' service times are sampled from.
+ */
+SetSeed::SetSeed(unsigned long long seed) : BaseAction(), seed(seed) { }
+
+void SetSeed::act(WareHouse &wareHouse) {
+    wareHouse.setSeed(seed);
+    complete();
+}
+
+SetSeed *SetSeed::clone() const {
+    return new SetSeed(*this);
+}
+
+/**
+ * @return "seed (seed)"
+ */
+string SetSeed::toString() const {
+    return "seed " + to_string(seed);
+}
+
+/*  Implementations for SetLogRetention - like AddVolunteer this action is only used by the config file.
+ */
 
+/**
+ * Creates a SetLogRetention action, config file syntax: log_retention all / ring (limit) / spill (limit) (file)
+ * @param retention which of the performed actions the log keeps.
+ * @param limit amount of actions kept in memory, ignored by LogRetention::All.
+ * @param spillPath the file older actions are written to, LogRetention::Spill only.
+ */
+SetLogRetention::SetLogRetention(LogRetention retention, unsigned long limit, const string &spillPath) :
+    BaseAction(), retention(retention), limit(limit), spillPath(spillPath) { }
 
+void SetLogRetention::act(WareHouse &wareHouse) {
+    if (wareHouse.setLogRetention(retention, limit, spillPath)) {
+        complete();
+    } else {
+        error("Failed to open the log spill file: " + spillPath);
+        std::cout << getErrorMsg() << std::endl;
+    }
+}
+
+SetLogRetention *SetLogRetention::clone() const {
+    return new SetLogRetention(*this);
+}
+
+/**
+ * @return "log_retention (all/ring limit/spill limit file)"
+ */
+string SetLogRetention::toString() const {
+    if (retention == LogRetention::Ring) return "log_retention ring " + to_string(limit);
+    if (retention == LogRetention::Spill) return "log_retention spill " + to_string(limit) + " " + spillPath;
+    return "log_retention all";
+}
+
+/*  Implementations for SetScheduler - like AddVolunteer this action is only used by the config file.
+ */
+
+/**
+ * Creates a SetScheduler action, config file syntax: scheduler (fifo/priority/edf) (soldier_sla civilian_sla)(edf only, optional)
+ * @param policy which pending orders are served first.
+ * @param soldierSla steps a soldier's order may take, used by edf.
+ * @param civilianSla steps a civilian's order may take, used by edf.
+ */
+SetScheduler::SetScheduler(SchedulerPolicy policy, int soldierSla, int civilianSla) :
+    BaseAction(), policy(policy), soldierSla(soldierSla), civilianSla(civilianSla) { }
+
+void SetScheduler::act(WareHouse &wareHouse) {
+    wareHouse.setScheduler(Scheduler::create(policy, soldierSla, civilianSla));
+    complete();
+}
+
+SetScheduler *SetScheduler::clone() const {
+    return new SetScheduler(*this);
+}
+
+/**
+ * @return the config line, e.g. "scheduler edf 5 15"
+ */
+string SetScheduler::toString() const {
+    Scheduler *scheduler = Scheduler::create(policy, soldierSla, civilianSla);
+    string output = scheduler->toString();
+    delete scheduler;
+    return output;
+}
+
+/*  Implementations for PrintLatency
+ */
+
+PrintLatency::PrintLatency() : BaseAction() { }
+
+/**
+ * Nearest rank percentile.
+ * @param sorted the latencies, sorted.
+ */
+static int percentile(const vector<int> &sorted, int percent) {
+    unsigned long rank = (sorted.size() * percent + 99) / 100;
+    return sorted[rank == 0 ? 0 : rank - 1];
+}
+
+/**
+ * Prints the p50 and p99 latencies (steps from placing an order until it's completed) of the completed orders
+ * of each customer type.
+ */
+void PrintLatency::act(WareHouse &wareHouse) {
+    const CustomerType types[] = {CustomerType::Soldier, CustomerType::Civilian};
+    for (CustomerType type : types) {
+        vector<int> latencies = wareHouse.getLatencies(type);
+        std::sort(latencies.begin(), latencies.end());
+        cout << (type == CustomerType::Soldier ? "Soldier" : "Civilian") << " - CompletedOrders: " << latencies.size();
+        if (latencies.empty()) {
+            cout << ", p50: None, p99: None" << endl;
+        } else {
+            cout << ", p50: " << percentile(latencies, 50) << ", p99: " << percentile(latencies, 99) << endl;
+        }
+    }
+    complete();
+}
+
+PrintLatency *PrintLatency::clone() const {
+    return new PrintLatency(*this);
+}
+
+/**
+ * @return "latency " + status
+ */
+string PrintLatency::toString() const {
+    return "latency " + getStatusString();
+}
+
+/*  Implementations for PrintMemory
+ */
+
+PrintMemory::PrintMemory() : BaseAction() { }
+
+/**
+ * Prints the live bytes and the amount of objects of each category of the warehouse's memory, then what the
+ * backup holds. The bytes are counted by the allocators in the warehouse's own context (see MemoryContext), so
+ * forks, snapshots and other warehouses of the process aren't included. The names are the shared pool's,
+ * counted once, and this action itself isn't counted as it isn't logged yet.
+ */
+void PrintMemory::act(WareHouse &wareHouse) {
+    MemoryUsage usage = wareHouse.getMemoryUsage() + wareHouse.getNames()->getMemoryUsage();
+    usage.bytes[(int) MemoryCategory::Actions] -= sizeof(PrintMemory);
+    usage.objects[(int) MemoryCategory::Actions]--;
+    long backupBytes = backup != nullptr ? backup->getMemoryUsage().totalBytes() : 0;
+    long orders = wareHouse.getOrderCount();
+    long counts[MEMORY_CATEGORY_COUNT] = {
+        (long) wareHouse.getPendingOrders().size(), (long) wareHouse.getInProcessOrders().size(),
+        (long) wareHouse.getCompletedOrders().size(), orders, orders, orders,
+        (long) wareHouse.getCustomerCount(), orders, usage.objects[(int) MemoryCategory::Volunteers],
+        usage.objects[(int) MemoryCategory::Actions], (long) wareHouse.getNames()->size()};
+    const char *units[MEMORY_CATEGORY_COUNT] = {"orders", "orders", "orders", "orders", "orders", "orders",
+                                                "customers", "order ids", "volunteers", "actions", "names"};
+    for (int i = 0; i < MEMORY_CATEGORY_COUNT; i++) {
+        cout << MemoryAccounting::categoryName((MemoryCategory) i) << ": " << usage.bytes[i] << " bytes, "
+             << counts[i] << " " << units[i] << endl;
+    }
+    if (backup != nullptr) {
+        cout << "Backup: " << backupBytes << " bytes, " << backup->getOrderCount() << " orders" << endl;
+    } else {
+        cout << "Backup: None" << endl;
+    }
+    cout << "Total: " << usage.totalBytes() + backupBytes << " bytes" << endl;
+    complete();
+}
+
+PrintMemory *PrintMemory::clone() const {
+    return new PrintMemory(*this);
+}
+
+/**
+ * @return "mem " + status
+ */
+string PrintMemory::toString() const {
+    return "mem " + getStatusString();
+}
+
+/*  Implementations for QueryOrders
+ */
+
+/**
+ * @param query the predicates the printed orders match.
+ */
+QueryOrders::QueryOrders(const OrderQuery &query) : BaseAction(), query(query) { }
+
+/**
+ * Prints a line per order matching the query (up to its limit), ascending by id, then how many orders matched.
+ * Answered from the warehouse's order indexes.
+ */
+void QueryOrders::act(WareHouse &wareHouse) {
+    const char *statuses[] = {"Pending", "Collecting", "Delivering", "Completed"};
+    int matched = 0;
+    for (int orderId : wareHouse.queryOrders(query, matched)) {
+        const Order &order = *wareHouse.findOrder(orderId); // The indexes only hold existing orders
+        cout << "OrderID: " << orderId << ", OrderStatus: " << statuses[(int) order.getStatus()]
+             << ", CustomerID: " << order.getCustomerId()
+             << ", CollectorID: " << (order.getCollectorId() == NO_VOLUNTEER ? "None" : to_string(order.getCollectorId()))
+             << ", DriverID: " << (order.getDriverId() == NO_VOLUNTEER ? "None" : to_string(order.getDriverId()))
+             << ", Distance: " << order.getDistance() << endl;
+    }
+    cout << "Matched: " << matched << endl;
+    complete();
+}
+
+QueryOrders *QueryOrders::clone() const {
+    return new QueryOrders(*this);
+}
+
+/**
+ * @return "query orders (predicates) (status)"
+ */
+string QueryOrders::toString() const {
+    string predicates = query.toString();
+    return "query orders " + (predicates.empty() ? "" : predicates + " ") + getStatusString();
+}
+
+/*  Implementations for WhatIf
+ */
+
+/**
+ * @param steps amount of steps every scenario performs.
+ * @param variants the scenarios, the base scenario (no changes) first.
+ */
+WhatIf::WhatIf(int steps, const vector<ScenarioVariant> &variants) : BaseAction(), steps(steps), variants(variants) { }
+
+/**
+ * Runs every scenario on its own fork of the warehouse (see ScenarioRunner) and prints a line per scenario:
+ * the orders completed during the steps, the backlog left and the mean latency of the completed orders.
+ * The warehouse itself isn't changed.
+ */
+void WhatIf::act(WareHouse &wareHouse) {
+    vector<ScenarioOutcome> outcomes = wareHouse.getScenarioRunner().run(wareHouse, steps, variants);
+    for (unsigned long i = 0; i < variants.size(); i++) {
+        std::ostringstream latency;
+        latency.setf(std::ios::fixed);
+        latency.precision(2);
+        latency << outcomes[i].meanLatency;
+        cout << "Scenario: " << variants[i].name << ", CompletedOrders: " << outcomes[i].completed
+             << ", Backlog: " << outcomes[i].backlog
+             << ", MeanLatency: " << (outcomes[i].completed > 0 ? latency.str() : "None") << endl;
+    }
+    complete();
+}
+
+WhatIf *WhatIf::clone() const {
+    return new WhatIf(*this);
+}
+
+/**
+ * @return "whatif (steps) (variants) (status)"
+ */
+string WhatIf::toString() const {
+    string text = "whatif " + to_string(steps);
+    for (unsigned long i = 1; i < variants.size(); i++) text += " " + variants[i].name;
+    return text + " " + getStatusString();
+}
@@ -1,13 +1,63 @@
 #include <stdexcept>
 #include <iostream>
+#include <sstream>
+#include <algorithm>
+#include <cerrno>
+#include <climits>
+#include <cstdlib>
+#include <cmath>
 #include "../include/ActionFactory.h"
 #include "../include/Action.h"
 
 
 /**
- * Factory with default constructor.
+ * @param names the warehouse's names, customers' and volunteers' names are interned there.
  */
-ActionFactory::ActionFactory() = default;
+ActionFactory::ActionFactory(const shared_ptr<StringPool> &names) : names(names) { }
+
+/**
+ * Parses a number the way std::stol does (leading whitespace and a sign are allowed, anything after the digits is
+ * ignored) but reports a malformed number by returning false instead of throwing.
+ * @param value set to the parsed number.
+ * @returns false if the text doesn't start with a number or it's out of range.
+ */
+bool ActionFactory::parseLong(const string &text, long &value) {
+    const char *start = text.c_str();
+    char *end = nullptr;
+    errno = 0;
+    value = std::strtol(start, &end, 10);
+    return end != start && errno != ERANGE;
+}
+
+/**
+ * Like parseLong, for numbers in the range of an int (std::stoi).
+ */
+bool ActionFactory::parseInt(const string &text, int &value) {
+    long parsed;
+    if (!parseLong(text, parsed) || parsed < INT_MIN || parsed > INT_MAX) return false;
+    value = (int) parsed;
+    return true;
+}
+
+/**
+ * Like parseLong, for numbers in the range of an unsigned long long (std::stoull, a negative number wraps around).
+ */
+bool ActionFactory::parseUnsignedLong(const string &text, unsigned long long &value) {
+    const char *start = text.c_str();
+    char *end = nullptr;
+    errno = 0;
+    value = std::strtoull(start, &end, 10);
+    return end != start && errno != ERANGE;
+}
+
+/**
+ * Reports a command whose arguments are malformed.
+ * @returns nullptr, for returning from createAction.
+ */
+static BaseAction *badArguments() {
+    std::cout << "Unknown command (perhaps arguments were wrong)." << std::endl;
+    return nullptr;
+}
 
 /**
  * @param str - the command to be parsed
@@ -37,6 +87,139 @@ vector<string> splitIntoWords(const string& str) {
     return words;
 }
 
+/**
+ * Parses a variant of a whatif command, a comma separated list of changes: collectors=(count):(cool down),
+ * drivers=(count):(max distance):(distance per step) and orders=(count).
+ * @param names the added volunteers' name is interned there.
+ * @param variant set to the parsed variant.
+ * @returns false if a change is unknown, malformed or adds more than MAX_SCENARIO_VOLUNTEERS volunteers of a kind or
+ * MAX_SCENARIO_ORDERS orders, after reporting it like any malformed command.
+ */
+static bool parseVariant(const string &text, StringPool &names, ScenarioVariant &variant) {
+    variant.name = text;
+    std::istringstream changes(text);
+    string change;
+    while (std::getline(changes, change, ',')) {
+        string key = change.substr(0, change.find('='));
+        vector<int> values;
+        std::istringstream numbers(change.find('=') == string::npos ? "" : change.substr(change.find('=') + 1));
+        string number;
+        while (std::getline(numbers, number, ':')) {
+            values.push_back(0);
+            if (!ActionFactory::parseInt(number, values.back()) || values.back() < 0) {
+                badArguments();
+                return false;
+            }
+        }
+        if (key == "collectors" && values.size() == 2 && values[0] <= MAX_SCENARIO_VOLUNTEERS && values[1] > 0) {
+            variant.collectors = values[0];
+            variant.collectorCoolDown = values[1];
+        }
+        else if (key == "drivers" && values.size() == 3 && values[0] <= MAX_SCENARIO_VOLUNTEERS && values[2] > 0) {
+            variant.drivers = values[0];
+            variant.driverMaxDistance = values[1];
+            variant.driverDistancePerStep = values[2];
+        }
+        else if (key == "orders" && values.size() == 1 && values[0] <= MAX_SCENARIO_ORDERS) {
+            variant.orders = values[0];
+        }
+        else {
+            badArguments();
+            return false;
+        }
+    }
+    if (variant.collectors > 0 || variant.drivers > 0) {
+        variant.volunteerNameId = names.intern(SCENARIO_VOLUNTEER_NAME);
+    }
+    return true;
+}
+
+/**
+ * Parses the predicates of a query orders command: status=(pending/collecting/delivering/completed),
+ * customer=(id), collector=(id), driver=(id), distance(=/</<=/>/>=)(distance) and limit (count).
+ * @param words the command's words, the predicates start at the third word.
+ * @param query set to the parsed query.
+ * @returns false if a predicate is unknown or malformed, after printing it.
+ */
+static bool parseQuery(const vector<string> &words, OrderQuery &query) {
+    const char *statuses[] = {"pending", "collecting", "delivering", "completed"};
+    for (unsigned long i = 2; i < words.size(); i++) {
+        const string &predicate = words[i];
+        if (predicate == "limit" && i + 1 < words.size()) {
+            if (!ActionFactory::parseInt(words[++i], query.limit) || query.limit < 0) {
+                badArguments();
+                return false;
+            }
+            continue;
+        }
+        size_t operatorStart = predicate.find_first_of("<>=");
+        size_t valueStart = predicate.find_first_not_of("<>=", operatorStart);
+        if (operatorStart == string::npos || operatorStart == 0 || valueStart == string::npos) {
+            std::cout << "Unknown query predicate: " << predicate << std::endl;
+            return false;
+        }
+        string key = predicate.substr(0, operatorStart);
+        string comparison = predicate.substr(operatorStart, valueStart - operatorStart);
+        string value = predicate.substr(valueStart);
+        if (key == "distance") {
+            int distance;
+            if (!ActionFactory::parseInt(value, distance)) {
+                badArguments();
+                return false;
+            }
+            // The bounds are inclusive, distance>INT_MAX and distance<INT_MIN match nothing: an empty range.
+            if (comparison == ">" && distance == INT_MAX) {
+                query.maxDistance = INT_MIN;
+            }
+            else if (comparison == "=" || comparison == ">=" || comparison == ">") {
+                query.minDistance = std::max(query.minDistance, comparison == ">" ? distance + 1 : distance);
+            }
+            if (comparison == "<" && distance == INT_MIN) {
+                query.minDistance = INT_MAX;
+            }
+            else if (comparison == "=" || comparison == "<=" || comparison == "<") {
+                query.maxDistance = std::min(query.maxDistance, comparison == "<" ? distance - 1 : distance);
+            }
+            if (comparison != "=" && comparison != ">=" && comparison != ">" && comparison != "<=" && comparison != "<") {
+                std::cout << "Unknown query predicate: " << predicate << std::endl;
+                return false;
+            }
+            continue;
+        }
+        if (comparison != "=") {
+            std::cout << "Unknown query predicate: " << predicate << std::endl;
+            return false;
+        }
+        if (key == "status") {
+            std::transform(value.begin(), value.end(), value.begin(), ::tolower);
+            int status = 0;
+            while (status < ORDER_STATUS_COUNT && value != statuses[status]) status++;
+            if (status == ORDER_STATUS_COUNT) {
+                std::cout << "Unknown order status: " << value << std::endl;
+                return false;
+            }
+            query.byStatus = true;
+            query.status = (OrderStatus) status;
+        }
+        else if (key == "customer" || key == "collector" || key == "driver" || key == "limit") {
+            int id;
+            if (!ActionFactory::parseInt(value, id) || id < 0) {
+                badArguments();
+                return false;
+            }
+            if (key == "customer") query.customerId = id;
+            else if (key == "collector") query.collectorId = id;
+            else if (key == "driver") query.driverId = id;
+            else query.limit = id;
+        }
+        else {
+            std::cout << "Unknown query predicate: " << predicate << std::endl;
+            return false;
+        }
+    }
+    return true;
+}
+
 /**
  * Creates a new action according to the input, to use the action you get you have to use the act method.
  * @param input - string with each argument seperated by a space in the following format:
@@ -44,17 +227,31 @@ vector<string> splitIntoWords(const string& str) {
  * These are the different actions and args required:
  * step (number_of_steps),
  * order (customer_id),
+ * orders (customer_id) (count) / orders (customer_id,customer_id,...),
+ * generate (steps) rate=(orders per step) dist=(poisson/bursty)(optional) seed=(seed),
  * customer (customer_name) (customer_type) (customer_distance) (max_orders),
- * orderStatus (order_id),
- * customerStatus (customer_id),
+ * customers (csv_file_path),
+ * orderStatus (order_id) (@step)(optional),
+ * customerStatus (customer_id) (@step)(optional),
  * volunteerStatus (volunteer_id),
- * log,
+ * log (--tail count / --from first_entry --count count / --from first_entry)(optional),
  * close,
  * backup,
  * restore,
  * volunteer (volunteer_name) (volunteer_role)(options: collector/limited_collector/driver/limited_driver)
  * (volunteer_coolDown)/(volunteer_maxDistance)
  * (distance_per_step)(for drivers only) (volunteer_maxOrders)(optional)
+ * (capacity=orders_per_trip)(for drivers only, optional)
+ * (batch=orders_per_cycle)(extra_cooldown=time_per_extra_order)(for collectors only, optional)
+ * (service=fixed/uniform/exponential)(spread=percent)(optional),
+ * seed (seed)(config file only),
+ * log_retention (all / ring limit / spill limit spill_file)(config file only),
+ * dispatch (greedy/matching)(config file only),
+ * scheduler (fifo/priority/edf) (soldier_sla civilian_sla)(edf only, optional)(config file only),
+ * latency,
+ * query orders (predicates)(optional, see parseQuery),
+ * mem,
+ * whatif (steps) (variants)(optional, see parseVariant)
  * @param isOpen - Where the warehouse is open or not. So that the function knows if it can use the volunteer command.
  * @return - A new action according to the action_name, to use the action you have to use the act method. Or a nullptr
  * if the actionType is unknown.
@@ -63,81 +260,251 @@ BaseAction *ActionFactory::createAction(const string &input, bool isOpen) {
     vector<string> commands = splitIntoWords(input);
     if (!commands.empty()) {
         string type = commands[0]; // First word should be the action type
-        try {
-            int size = commands.size();
-            if (type == STEP && size == 2) {
-                int numOfSteps = std::stoi(commands[1]);
-                return new SimulateStep(numOfSteps);
-            }
-            else if (type == ORDER && size == 2) {
-                int orderId = std::stoi(commands[1]);
-                return new AddOrder(orderId);
-            }
-            else if (type == CUSTOMER && size == 5) {
-                string customerName = commands[1];
-                string customerType = commands[2];
-                int distance = std::stoi(commands[3]);
-                int maxOrders = std::stoi(commands[4]);
-                return new AddCustomer(customerName, customerType, distance, maxOrders);
-            }
-            else if (type == ORDERSTATUS && size == 2) {
-                int orderId = std::stoi(commands[1]);
-                return new PrintOrderStatus(orderId);
-            }
-            else if (type == CUSTOMERSTATUS && size == 2) {
-                int customerId = std::stoi(commands[1]);
-                return new PrintCustomerStatus(customerId);
-            }
-            else if (type == VOLUNTEERSTATUS && size == 2) {
-                int volunteerId = std::stoi(commands[1]);
-                return new PrintVolunteerStatus(volunteerId);
-            }
-            else if (type == LOG) {
-                return new PrintActionsLog();
-            }
-            else if (type == CLOSE) {
-                return new Close();
-            }
-            else if (type == BACKUP) {
-                return new BackupWareHouse();
-            }
-            else if (type == RESTORE) {
-                return new RestoreWareHouse();
-            }
-            else if (!isOpen && type == VOLUNTEER  && size > 3) {
-                string volunteerName = commands[1];
-                string volunteerRole = commands[2];
-                if (volunteerRole == "collector") {
-                    int cooldown = std::stoi(commands[3]);
-                    return new AddVolunteer(volunteerName, cooldown, NOT_LIMITED);
+        int size = commands.size();
+        if (type == STEP && size == 2) {
+            int numOfSteps;
+            if (!parseInt(commands[1], numOfSteps)) return badArguments();
+            return new SimulateStep(numOfSteps);
+        }
+        else if (type == ORDER && size == 2) {
+            int orderId;
+            if (!parseInt(commands[1], orderId)) return badArguments();
+            return new AddOrder(orderId);
+        }
+        else if (type == ORDERS && size == 3) {
+            int customerId, count;
+            if (!parseInt(commands[1], customerId) || !parseInt(commands[2], count) || count < 0) {
+                return badArguments();
+            }
+            return new AddOrders(customerId, count);
+        }
+        else if (type == ORDERS && size == 2) {
+            vector<int> customerIds;
+            string customerId;
+            std::stringstream list(commands[1]);
+            while (getline(list, customerId, ',')) {
+                customerIds.push_back(0);
+                if (!parseInt(customerId, customerIds.back())) return badArguments();
+            }
+            return new AddOrders(customerIds);
+        }
+        else if (type == CUSTOMERS && size == 2) {
+            return new AddCustomers(commands[1]);
+        }
+        else if (type == CUSTOMER && size == 5) {
+            string customerName = commands[1];
+            string customerType = commands[2];
+            int distance, maxOrders;
+            if (!parseInt(commands[3], distance) || !parseInt(commands[4], maxOrders)) return badArguments();
+            return new AddCustomer(names, customerName, customerType, distance, maxOrders);
+        }
+        else if ((type == ORDERSTATUS || type == CUSTOMERSTATUS) && (size == 2 || size == 3)) {
+            int id;
+            int atStep = NO_STEP;
+            if (!parseInt(commands[1], id)) return badArguments();
+            if (size == 3 && (commands[2][0] != '@' || !parseInt(commands[2].substr(1), atStep) || atStep < 0)) {
+                return badArguments();
+            }
+            if (type == ORDERSTATUS) return new PrintOrderStatus(id, atStep);
+            return new PrintCustomerStatus(id, atStep);
+        }
+        else if (type == VOLUNTEERSTATUS && size == 2) {
+            int volunteerId;
+            if (!parseInt(commands[1], volunteerId)) return badArguments();
+            return new PrintVolunteerStatus(volunteerId);
+        }
+        else if (type == LOG && size == 3 && commands[1] == "--tail") {
+            long count;
+            if (!parseLong(commands[2], count) || count < 0) return badArguments();
+            return new PrintActionsLog(0, count, true);
+        }
+        else if (type == LOG && (size == 3 || (size == 5 && commands[3] == "--count")) && commands[1] == "--from") {
+            long from, count = LOG_ALL;
+            if (!parseLong(commands[2], from) || (size == 5 && !parseLong(commands[4], count)) || from < 0 ||
+                count < LOG_ALL) {
+                return badArguments();
+            }
+            return new PrintActionsLog(from, count);
+        }
+        else if (type == LOG && (size == 1 || commands[1].compare(0, 2, "--") != 0)) {
+            return new PrintActionsLog();
+        }
+        else if (type == CLOSE) {
+            return new Close();
+        }
+        else if (type == BACKUP) {
+            return new BackupWareHouse();
+        }
+        else if (type == RESTORE) {
+            return new RestoreWareHouse();
+        }
+        else if (type == LATENCY) {
+            return new PrintLatency();
+        }
+        else if (type == MEM) {
+            return new PrintMemory();
+        }
+        else if (type == QUERY && size > 1 && commands[1] == "orders") {
+            OrderQuery query;
+            if (parseQuery(commands, query)) {
+                return new QueryOrders(query);
+            }
+        }
+        else if (type == GENERATE && size > 2) {
+            int steps;
+            double rate = -1;
+            ArrivalDistribution distribution = ArrivalDistribution::Poisson;
+            bool seeded = false;
+            unsigned long long seed = 0;
+            if (!parseInt(commands[1], steps)) return badArguments();
+            for (int i = 2; i < size; i++) {
+                string key = commands[i].substr(0, commands[i].find('='));
+                string value = commands[i].find('=') == string::npos ? "" : commands[i].substr(key.size() + 1);
+                if (key == "rate") {
+                    char *end = nullptr;
+                    rate = std::strtod(value.c_str(), &end);
+                    if (end == value.c_str()) return badArguments();
                 }
-                else if (volunteerRole == "limited_collector" && size > 4) {
-                    int cooldown = std::stoi(commands[3]);
-                    int maxOrders = std::stoi(commands[4]);
-                    return new AddVolunteer(volunteerName, cooldown, maxOrders);
+                else if (key == "seed") {
+                    if (!parseUnsignedLong(value, seed)) return badArguments();
+                    seeded = true;
                 }
-                else if (volunteerRole == "driver" && size > 4) {
-                    int maxDistance = std::stoi(commands[3]);
-                    int distancePerStep = std::stoi(commands[4]);
-                    return new AddVolunteer(volunteerName, maxDistance, distancePerStep, NOT_LIMITED);
+                else if (key != "dist" || !ArrivalProcess::parseDistribution(value, distribution)) {
+                    return badArguments();
                 }
-                else if (volunteerRole == "limited_driver" && size > 5) {
-                    int maxDistance = std::stoi(commands[3]);
-                    int distancePerStep = std::stoi(commands[4]);
-                    int maxOrders = std::stoi(commands[5]);
-                    return new AddVolunteer(volunteerName, maxDistance, distancePerStep, maxOrders);
+            }
+            if (steps < 0 || !std::isfinite(rate) || rate < 0 || rate > MAX_ARRIVAL_RATE || !seeded) {
+                return badArguments();
+            }
+            return new GenerateOrders(steps, rate, distribution, seed);
+        }
+        else if (type == WHATIF && size > 1) {
+            int steps;
+            if (!parseInt(commands[1], steps) || steps < 0) return badArguments();
+            vector<ScenarioVariant> variants(1); // The base scenario comes first
+            for (unsigned long i = 2; i < commands.size(); i++) {
+                if (commands[i] == "base") continue;
+                variants.push_back(ScenarioVariant());
+                if (!parseVariant(commands[i], *names, variants.back())) return nullptr;
+            }
+            return new WhatIf(steps, variants);
+        }
+        else if (!isOpen && type == VOLUNTEER  && size > 3) {
+            string volunteerName = commands[1];
+            string volunteerRole = commands[2];
+            // key=value options may follow the positional arguments.
+            VolunteerOptions options;
+            bool collector = volunteerRole == "collector" || volunteerRole == "limited_collector";
+            bool spread = false;
+            while (size > 3 && commands[size - 1].find('=') != string::npos) {
+                string option = commands[size - 1];
+                string key = option.substr(0, option.find('='));
+                string value = option.substr(option.find('=') + 1);
+                if (key == "capacity" && !collector) {
+                    if (!parseInt(value, options.capacity)) return badArguments();
+                }
+                else if (key == "batch" && collector) {
+                    if (!parseInt(value, options.batchSize)) return badArguments();
+                }
+                else if (key == "extra_cooldown" && collector) {
+                    if (!parseInt(value, options.extraCoolDown)) return badArguments();
+                }
+                else if (key == "service") {
+                    if (!ServiceTime::parseDistribution(value, options.service)) {
+                        std::cout << "Unknown service time distribution: " << value << std::endl;
+                        return nullptr;
+                    }
+                }
+                else if (key == "spread") {
+                    if (!parseInt(value, options.spread)) return badArguments();
+                    spread = true;
+                }
+                else if (key == "capacity" || key == "batch" || key == "extra_cooldown") {
+                    std::cout << "Volunteer option " << key << " doesn't apply to a " << volunteerRole << std::endl;
+                    return nullptr;
                 }
                 else {
-                    std::cout << "Unknown volunteer role: " << volunteerRole << std::endl;
+                    std::cout << "Unknown volunteer option: " << key << std::endl;
+                    return nullptr;
                 }
+                size--;
             }
-            else {
-                std::cout << type << " is an unknown command or perhaps you had missing arguments." << std::endl;
+            if (spread && options.service != ServiceDistribution::Uniform) {
+                std::cout << "Volunteer option spread only applies to service=uniform" << std::endl;
                 return nullptr;
             }
+            if (volunteerRole == "collector") {
+                int cooldown;
+                if (!parseInt(commands[3], cooldown)) return badArguments();
+                return new AddVolunteer(names->intern(volunteerName), cooldown, NOT_LIMITED, options);
+            }
+            else if (volunteerRole == "limited_collector" && size > 4) {
+                int cooldown, maxOrders;
+                if (!parseInt(commands[3], cooldown) || !parseInt(commands[4], maxOrders)) return badArguments();
+                return new AddVolunteer(names->intern(volunteerName), cooldown, maxOrders, options);
+            }
+            else if (volunteerRole == "driver" && size > 4) {
+                int maxDistance, distancePerStep;
+                if (!parseInt(commands[3], maxDistance) || !parseInt(commands[4], distancePerStep)) {
+                    return badArguments();
+                }
+                return new AddVolunteer(names->intern(volunteerName), maxDistance, distancePerStep, NOT_LIMITED, options);
+            }
+            else if (volunteerRole == "limited_driver" && size > 5) {
+                int maxDistance, distancePerStep, maxOrders;
+                if (!parseInt(commands[3], maxDistance) || !parseInt(commands[4], distancePerStep) ||
+                    !parseInt(commands[5], maxOrders)) {
+                    return badArguments();
+                }
+                return new AddVolunteer(names->intern(volunteerName), maxDistance, distancePerStep, maxOrders, options);
+            }
+            else {
+                std::cout << "Unknown volunteer role: " << volunteerRole << std::endl;
+            }
+        }
+        else if (!isOpen && type == LOG_RETENTION && size == 2 && commands[1] == "all") {
+            return new SetLogRetention(LogRetention::All, LOG_UNLIMITED, "");
+        }
+        else if (!isOpen && type == LOG_RETENTION && ((size == 3 && commands[1] == "ring") ||
+                                                      (size == 4 && commands[1] == "spill"))) {
+            long limit;
+            if (!parseLong(commands[2], limit) || limit < 1) return badArguments(); // Keeps at least one action
+            return new SetLogRetention(commands[1] == "ring" ? LogRetention::Ring : LogRetention::Spill, limit,
+                                       size == 4 ? commands[3] : "");
+        }
+        else if (!isOpen && type == SEED && size == 2) {
+            unsigned long long seed;
+            if (!parseUnsignedLong(commands[1], seed)) return badArguments();
+            return new SetSeed(seed);
+        }
+        else if (!isOpen && type == DISPATCH && size == 2) {
+            if (commands[1] == "greedy") {
+                return new SetDispatchPolicy(DispatchPolicy::Greedy);
+            }
+            else if (commands[1] == "matching") {
+                return new SetDispatchPolicy(DispatchPolicy::Matching);
+            }
+            std::cout << "Unknown dispatch policy: " << commands[1] << std::endl;
+        }
+        else if (!isOpen && type == SCHEDULER && (size == 2 || size == 4)) {
+            int soldierSla = DEFAULT_SOLDIER_SLA, civilianSla = DEFAULT_CIVILIAN_SLA;
+            if (size == 4 && (!parseInt(commands[2], soldierSla) || !parseInt(commands[3], civilianSla))) {
+                return badArguments();
+            }
+            if (commands[1] == "fifo") {
+                return new SetScheduler(SchedulerPolicy::Fifo, soldierSla, civilianSla);
+            }
+            else if (commands[1] == "priority") {
+                return new SetScheduler(SchedulerPolicy::Priority, soldierSla, civilianSla);
+            }
+            else if (commands[1] == "edf") {
+                return new SetScheduler(SchedulerPolicy::Edf, soldierSla, civilianSla);
+            }
+            std::cout << "Unknown scheduler: " << commands[1] << std::endl;
         }
-        catch (exception &ex) {
-            std::cout << "Unknown command (perhaps arguments were wrong)." << std::endl;
+        else {
+            std::cout << type << " is an unknown command or perhaps you had missing arguments." << std::endl;
+            return nullptr;
         }
     } else {
         std::cout << "Received empty line, make sure you type the command correctly." << std::endl;
@@ -0,0 +1,231 @@
+#include "../include/ActionLog.h"
+#include "../include/Action.h"
+
+#include <algorithm>
+#include <limits>
+
+ActionLog::ActionLog() :
+    entries(),
+    head(0),
+    logged(0),
+    retention(LogRetention::All),
+    limit(LOG_UNLIMITED),
+    spill(),
+    spilling(false),
+    spilled(0),
+    spillBytes(0),
+    spillIndex()
+{ }
+
+/**
+ * The copy shares the spill file but never writes to it.
+ */
+ActionLog::ActionLog(const ActionLog &other) :
+    entries(),
+    head(0),
+    logged(other.logged),
+    retention(other.retention),
+    limit(other.limit),
+    spill(other.spill),
+    spilling(false),
+    spilled(other.spilled),
+    spillBytes(other.spillBytes),
+    spillIndex(other.spillIndex)
+{
+    copyEntries(other);
+}
+
+ActionLog::ActionLog(ActionLog &&other) noexcept :
+    entries(std::move(other.entries)),
+    head(other.head),
+    logged(other.logged),
+    retention(other.retention),
+    limit(other.limit),
+    spill(std::move(other.spill)),
+    spilling(other.spilling),
+    spilled(other.spilled),
+    spillBytes(other.spillBytes),
+    spillIndex(std::move(other.spillIndex))
+{
+    other.entries.clear();
+    other.head = 0;
+    other.logged = 0;
+    other.spilling = false;
+    other.spilled = 0;
+}
+
+/**
+ * Replaces the entries with copies of the other log's, this log takes over writing the shared spill file.
+ */
+ActionLog &ActionLog::operator=(const ActionLog &other) {
+    if (this == &other) return *this;
+    deleteEntries();
+    logged = other.logged;
+    retention = other.retention;
+    limit = other.limit;
+    spill = other.spill;
+    spilling = other.spill != nullptr;
+    spilled = other.spilled;
+    spillBytes = other.spillBytes;
+    spillIndex = other.spillIndex;
+    copyEntries(other);
+    return *this;
+}
+
+ActionLog &ActionLog::operator=(ActionLog &&other) noexcept {
+    if (this == &other) return *this;
+    deleteEntries();
+    entries.swap(other.entries);
+    head = other.head;
+    logged = other.logged;
+    retention = other.retention;
+    limit = other.limit;
+    spill = std::move(other.spill);
+    spilling = other.spilling;
+    spilled = other.spilled;
+    spillBytes = other.spillBytes;
+    spillIndex.swap(other.spillIndex);
+    other.head = 0;
+    other.logged = 0;
+    other.spilling = false;
+    other.spilled = 0;
+    return *this;
+}
+
+ActionLog::~ActionLog() {
+    deleteEntries();
+}
+
+/**
+ * Clones the other log's in-memory entries, oldest first.
+ */
+void ActionLog::copyEntries(const ActionLog &other) {
+    unsigned long size = other.entries.size();
+    entries.reserve(size);
+    for (unsigned long i = 0; i < size; i++) {
+        entries.push_back(other.entries[(other.head + i) % size]->clone());
+    }
+    head = 0;
+}
+
+void ActionLog::deleteEntries() {
+    for (BaseAction *action : entries) delete action;
+    entries.clear();
+    head = 0;
+}
+
+/**
+ * Writes the oldest in-memory entry's text to the spill file, as entry number spilled.
+ */
+void ActionLog::spillOldest() {
+    if (spilled % SPILL_INDEX_STRIDE == 0) spillIndex.push_back(spillBytes);
+    string line = entries[head]->toString() + "\n";
+    spill->clear();
+    spill->seekp(spillBytes);
+    spill->write(line.data(), line.size());
+    spillBytes += line.size();
+    spilled++;
+}
+
+/**
+ * Sets how many entries are kept, meant for the config file. Entries over the new limit are dropped (or
+ * spilled) right away, entries spilled under a previous policy are forgotten.
+ * @param limit amount of entries kept in memory, ignored for LogRetention::All.
+ * @param spillPath the spill file for LogRetention::Spill, truncated.
+ * @returns false if the spill file couldn't be opened, the retention is then unchanged.
+ */
+bool ActionLog::setRetention(LogRetention retention, unsigned long limit, const string &spillPath) {
+    shared_ptr<std::fstream> file;
+    if (retention == LogRetention::Spill) {
+        file = std::make_shared<std::fstream>(spillPath, std::ios::in | std::ios::out | std::ios::trunc |
+                                                         std::ios::binary);
+        if (!*file) return false;
+    }
+    std::rotate(entries.begin(), entries.begin() + head, entries.end());
+    head = 0;
+    this->retention = retention;
+    this->limit = retention == LogRetention::All ? LOG_UNLIMITED : limit;
+    spill = file;
+    spilling = file != nullptr;
+    spilled = 0;
+    spillBytes = 0;
+    spillIndex.clear();
+    if (this->limit != LOG_UNLIMITED && entries.size() > this->limit) {
+        unsigned long excess = entries.size() - this->limit;
+        for (head = 0; head < excess; head++) {
+            if (spilling) spillOldest();
+            delete entries[head];
+        }
+        entries.erase(entries.begin(), entries.begin() + excess);
+        head = 0;
+    }
+    return true;
+}
+
+LogRetention ActionLog::getRetention() const {
+    return retention;
+}
+
+/**
+ * Logs a performed action, the log takes ownership of it. O(1), with a limit the oldest entry is dropped
+ * or spilled once the ring is full.
+ */
+void ActionLog::append(BaseAction *action) {
+    if (limit == LOG_UNLIMITED || entries.size() < limit) {
+        entries.push_back(action);
+    } else {
+        if (spilling) spillOldest();
+        delete entries[head];
+        entries[head] = action;
+        head = (head + 1) % limit;
+    }
+    logged++;
+}
+
+long ActionLog::size() const {
+    return logged;
+}
+
+/**
+ * @returns the oldest entry that can still be printed, 0 unless a ring dropped entries.
+ */
+long ActionLog::getFirstKept() const {
+    return spilled > 0 ? 0 : logged - (long) entries.size();
+}
+
+/**
+ * Prints the entries from..from + count - 1 that are still kept, one action per line. Only the slice is read:
+ * spilled entries from the nearest indexed offset before it, in-memory entries directly.
+ * @param count amount of entries, a negative count prints up to the last entry.
+ */
+void ActionLog::print(long from, long count, std::ostream &out) const {
+    long end = (count < 0 || count > logged - from) ? logged : from + count;
+    if (from < 0) from = 0;
+    if (from < spilled && from < end) {
+        spill->flush();
+        spill->clear();
+        spill->seekg(spillIndex[from / SPILL_INDEX_STRIDE]);
+        for (long i = from / SPILL_INDEX_STRIDE * SPILL_INDEX_STRIDE; i < from; i++) {
+            spill->ignore(std::numeric_limits<std::streamsize>::max(), '\n');
+        }
+        string line;
+        for (long i = from; i < end && i < spilled && std::getline(*spill, line); i++) {
+            out << line << std::endl;
+        }
+    }
+    long inMemory = logged - (long) entries.size();
+    for (long i = std::max(from, inMemory); i < end; i++) {
+        out << entries[(head + (i - inMemory)) % entries.size()]->toString() << std::endl;
+    }
+}
+
+/**
+ * Deletes all the entries, the retention policy and the spill file are kept.
+ */
+void ActionLog::clear() {
+    deleteEntries();
+    logged = 0;
+    spilled = 0;
+    spillBytes = 0;
+    spillIndex.clear();
+}
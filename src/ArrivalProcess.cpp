@@ -0,0 +1,69 @@
+#include "../include/ArrivalProcess.h"
+
+#include <cmath>
+#include <algorithm>
+
+/**
+ * @param rate mean amount of orders per step.
+ */
+ArrivalProcess::ArrivalProcess(unsigned long long seed, double rate, ArrivalDistribution distribution) :
+    state(seed), rate(rate), distribution(distribution) { }
+
+unsigned long long ArrivalProcess::nextBits() {
+    unsigned long long z = (state += 0x9E3779B97F4A7C15ULL);
+    z = (z ^ (z >> 30)) * 0xBF58476D1CE4E5B9ULL;
+    z = (z ^ (z >> 27)) * 0x94D049BB133111EBULL;
+    return z ^ (z >> 31);
+}
+
+double ArrivalProcess::nextDouble() {
+    return (double) (nextBits() >> 11) * (1.0 / 9007199254740992.0);
+}
+
+/**
+ * Knuth's method, a normal approximation for large means (where Knuth's method underflows).
+ */
+long ArrivalProcess::poisson(double mean) {
+    if (mean > 30) {
+        double u1 = std::max(nextDouble(), 1e-12), u2 = nextDouble();
+        double normal = std::sqrt(-2.0 * std::log(u1)) * std::cos(6.283185307179586 * u2);
+        return std::max(0L, std::lround(mean + normal * std::sqrt(mean)));
+    }
+    double limit = std::exp(-mean), product = nextDouble();
+    long count = 0;
+    while (product > limit) {
+        product *= nextDouble();
+        count++;
+    }
+    return count;
+}
+
+/**
+ * @returns the amount of orders arriving at the next step.
+ */
+long ArrivalProcess::next() {
+    if (distribution == ArrivalDistribution::Bursty) {
+        return nextDouble() * BURST_PERIOD < 1 ? poisson(rate * BURST_PERIOD) : 0;
+    }
+    return poisson(rate);
+}
+
+int ArrivalProcess::pick(int count) {
+    return (int) (nextBits() % (unsigned long long) count);
+}
+
+/**
+ * @param name one of poisson, bursty.
+ * @param distribution set to the matching distribution.
+ * @returns false if the name is unknown.
+ */
+bool ArrivalProcess::parseDistribution(const string &name, ArrivalDistribution &distribution) {
+    if (name == "poisson") distribution = ArrivalDistribution::Poisson;
+    else if (name == "bursty") distribution = ArrivalDistribution::Bursty;
+    else return false;
+    return true;
+}
+
+string ArrivalProcess::distributionName(ArrivalDistribution distribution) {
+    return distribution == ArrivalDistribution::Bursty ? "bursty" : "poisson";
+}
@@ -0,0 +1,147 @@
+#include "../include/CommandCodec.h"
+#include "../include/WareHouse.h"
+#include "../include/Action.h"
+
+#include <cstring>
+#include <algorithm>
+
+static void putInt(string &out, int32_t value) {
+    out.append((const char *) &value, sizeof(value));
+}
+
+static int32_t getInt(const char *data) {
+    int32_t value;
+    std::memcpy(&value, data, sizeof(value));
+    return value;
+}
+
+/**
+ * Parses text[start, end) if it's a plain non negative number.
+ * @returns false if the text isn't a plain number.
+ */
+static bool parseNumber(const string &text, size_t start, size_t end, int32_t &value) {
+    if (start >= end || end - start > 9 || (text[start] == '0' && end - start > 1)) return false;
+    value = 0;
+    for (size_t i = start; i < end; i++) {
+        if (text[i] < '0' || text[i] > '9') return false;
+        value = value * 10 + (text[i] - '0');
+    }
+    return true;
+}
+
+/**
+ * @param command a command as given to WareHouse::execute.
+ * @param payload buffer to append the command's payload to.
+ */
+void CommandCodec::encode(const string &command, string &payload) {
+    int32_t first, second;
+    size_t space = command.find(' ', 6);
+    if (command.compare(0, 5, "step ") == 0 && parseNumber(command, 5, command.size(), first)) {
+        payload += (char) CommandOpcode::Step;
+        putInt(payload, first);
+    }
+    else if (command.compare(0, 6, "order ") == 0 && parseNumber(command, 6, command.size(), first)) {
+        payload += (char) CommandOpcode::Order;
+        putInt(payload, first);
+    }
+    else if (command.compare(0, 7, "orders ") == 0 && space != string::npos &&
+             parseNumber(command, 7, space, first) && parseNumber(command, space + 1, command.size(), second)) {
+        payload += (char) CommandOpcode::Orders;
+        putInt(payload, first);
+        putInt(payload, second);
+    }
+    else {
+        payload += (char) CommandOpcode::Text;
+        payload += command;
+    }
+}
+
+/**
+ * @param filePath the file the customers command read.
+ * @param opened false if the file couldn't be opened, the command is replayed as failing to open it.
+ * @param rows the rows read from the file, without the skipped lines.
+ * @param payload buffer to append the command's payload to.
+ */
+void CommandCodec::encodeCustomers(const string &filePath, bool opened, const vector<string> &rows,
+                                   string &payload) {
+    payload += (char) CommandOpcode::Customers;
+    payload += filePath;
+    if (!opened) return;
+    payload += '\0';
+    for (const string &row : rows) {
+        payload += row;
+        payload += '\n';
+    }
+}
+
+/**
+ * @returns true if the command is a step command with a plain numeric argument.
+ */
+bool CommandCodec::isStep(const string &command) {
+    int32_t steps;
+    return command.compare(0, 5, "step ") == 0 && parseNumber(command, 5, command.size(), steps);
+}
+
+/**
+ * @returns true if the command is a generate command.
+ */
+bool CommandCodec::isGenerate(const string &command) {
+    return command.compare(0, 9, "generate ") == 0;
+}
+
+/**
+ * @param payload a payload written by encode or encodeCustomers.
+ * @param size the payload's size.
+ * @param action set to a new action for binary commands, nullptr for text ones.
+ * @param text set to the command's text for text commands.
+ * @returns false if the payload is malformed.
+ */
+bool CommandCodec::decode(const char *payload, uint32_t size, BaseAction *&action, string &text) {
+    action = nullptr;
+    if (size == 0) return false;
+    CommandOpcode opcode = (CommandOpcode) payload[0];
+    if (opcode == CommandOpcode::Step && size == 5) {
+        action = new SimulateStep(getInt(payload + 1));
+    }
+    else if (opcode == CommandOpcode::Order && size == 5) {
+        action = new AddOrder(getInt(payload + 1));
+    }
+    else if (opcode == CommandOpcode::Orders && size == 9) {
+        action = new AddOrders(getInt(payload + 1), getInt(payload + 5));
+    }
+    else if (opcode == CommandOpcode::Customers) {
+        const char *end = payload + size;
+        const char *pathEnd = std::find(payload + 1, end, '\0');
+        string filePath(payload + 1, pathEnd);
+        if (pathEnd == end) {
+            action = new AddCustomers(filePath, false, vector<string>());
+            return true;
+        }
+        vector<string> rows;
+        for (const char *row = pathEnd + 1; row < end; ) {
+            const char *rowEnd = std::find(row, end, '\n');
+            if (rowEnd == end) return false;
+            rows.push_back(string(row, rowEnd));
+            row = rowEnd + 1;
+        }
+        action = new AddCustomers(filePath, true, rows);
+    }
+    else if (opcode == CommandOpcode::Text) {
+        text.assign(payload + 1, size - 1);
+    }
+    else return false;
+    return true;
+}
+
+/**
+ * Performs and logs the command, as WareHouse::execute would.
+ * @returns false if the payload is malformed.
+ */
+bool CommandCodec::perform(const char *payload, uint32_t size, WareHouse &wareHouse) {
+    BaseAction *action;
+    string text;
+    if (!decode(payload, size, action, text)) return false;
+    if (action) wareHouse.perform(action);
+    else wareHouse.execute(text);
+    return true;
+}
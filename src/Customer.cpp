@@ -2,33 +2,43 @@
 
 #include <string>
 #include <vector>
+#include <algorithm>
+#include <type_traits>
 using std::string;
 using std::vector;
 
+#define MIN_REGION_CAPACITY 2 // Order ids reserved at a customer's first order
+
+static_assert(std::is_trivially_copyable<Customer>::value, "customers are copied as raw memory");
+
 // ####################################################################################### //
-//                                     AbstractCustomer                                    //
+//                                         Customer                                        //
 // ####################################################################################### //
 
 /**
  * Constructor
  * @param id - customer's identifier.
- * @param name - customer's name.
+ * @param nameId - id of the customer's name in the warehouse's StringPool.
+ * @param type - soldier or civilian.
  * @param locationDistance - customer's distance from the Warehouse.
  * @param maxOrders - customer's order limit.
  */
-Customer::Customer(int id, const string &name, int locationDistance, int maxOrders) :
+Customer::Customer(int id, uint32_t nameId, CustomerType type, int locationDistance, int maxOrders) :
 id(id),
-name(name),
+nameId(nameId),
 locationDistance(locationDistance),
 maxOrders(maxOrders),
-ordersId()
+numOrders(0),
+ordersStart(0),
+ordersCapacity(0),
+type(type)
 { /* Hi bodek/et */ }
 
 /**
- * @returns the customer's name.
+ * @returns id of the customer's name in the warehouse's StringPool.
  */
-const string & Customer::getName() const {
-    return name;
+uint32_t Customer::getNameId() const {
+    return nameId;
 }
 
 /**
@@ -38,6 +48,13 @@ int Customer::getId() const {
     return id;
 }
 
+/**
+ * @returns CustomerType::Soldier or CustomerType::Civilian
+ */
+CustomerType Customer::getType() const {
+    return type;
+}
+
 /**
  * @returns the customer's distance from the Warehouse.
  */
@@ -56,74 +73,147 @@ int Customer::getMaxOrders() const {
  * @returns num of orders the customer has made so far
  */
 int Customer::getNumOrders() const {
-   return ordersId.size();
+   return numOrders;
 }
 
 /**
  * @returns true if the customer can make another order, false otherwise.
  */
 bool Customer::canMakeOrder() const {
-    int size = ordersId.size(); // Was giving a warning comparing ordersId with maxOrders, so casting here.
-    return size < maxOrders;
+    return numOrders < maxOrders;
 }
 
-/**
- * @returns vector containing the customer's orders.
- */
-const vector<int> &Customer::getOrdersIds() const {
-    return ordersId;
+// ####################################################################################### //
+//                                       OrderIdRange                                      //
+// ####################################################################################### //
+
+OrderIdRange::OrderIdRange(const int *first, int count) : first(first), count(count) { }
+
+const int *OrderIdRange::begin() const {
+    return first;
+}
+
+const int *OrderIdRange::end() const {
+    return first + count;
+}
+
+int OrderIdRange::size() const {
+    return count;
+}
+
+bool OrderIdRange::empty() const {
+    return count == 0;
+}
+
+int OrderIdRange::operator[](int index) const {
+    return first[index];
 }
 
 /**
- * @param orderId - Adds an order to the customer's orders.
- * @returns -1 if the customer reached max orders, else returns the orderId.
+ * @returns the customer's latest order id, the range must not be empty.
  */
-int Customer::addOrder(int orderId) {
-    if(canMakeOrder()) {
-        ordersId.push_back(orderId);
-        return orderId;
-    }
-    return -1;
+int OrderIdRange::back() const {
+    return first[count - 1];
 }
 
 // ####################################################################################### //
-//                                     SoldierCustomer                                     //
+//                                      CustomerTable                                      //
 // ####################################################################################### //
 
+CustomerTable::CustomerTable() : customers(), orderIds(), unused(0) { }
+
 /**
- * Constructor
- * @param id - customer's identifier.
- * @param name - customer's name.
- * @param locationDistance - customer's distance from the Warehouse.
- * @param maxOrders - customer's order limit.
+ * Adds a customer, no order ids are reserved for it until its first order.
+ * @returns the new customer's id.
+ */
+int CustomerTable::add(uint32_t nameId, CustomerType type, int locationDistance, int maxOrders) {
+    int id = customers.size();
+    customers.push_back(Customer(id, nameId, type, locationDistance, maxOrders));
+    return id;
+}
+
+/**
+ * Makes room for count more customers, used before adding customers in bulk.
  */
-SoldierCustomer::SoldierCustomer(int id, string name, int locationDistance, int maxOrders) :
-Customer(id, name, locationDistance, maxOrders) { }
+void CustomerTable::reserve(unsigned long count) {
+    customers.reserve(customers.size() + count);
+}
+
+int CustomerTable::size() const {
+    return customers.size();
+}
 
 /**
- * @returns a pointer to a copy of the customer.
+ * @returns the customer with the given id, nullptr if it doesn't exist. O(1).
  */
-SoldierCustomer *SoldierCustomer::clone() const {
-    return new SoldierCustomer(*this);
+const Customer *CustomerTable::find(int customerId) const {
+    if (customerId < 0 || customerId >= (int) customers.size()) return nullptr;
+    return &customers[customerId];
 }
 
-// ####################################################################################### //
-//                                     CivilianCustomer                                    //
-// ####################################################################################### //
+const Customer &CustomerTable::operator[](int customerId) const {
+    return customers[customerId];
+}
 
 /**
- * Constructor
- * @param id - customer's identifier.
- * @param name - customer's name.
- * @param locationDistance - customer's distance from the Warehouse.
- * @param maxOrders - customer's order limit.
+ * Appends the order id to the customer's order ids. Amortized O(1).
+ * @returns false if the customer doesn't exist or reached its max orders.
  */
-CivilianCustomer::CivilianCustomer(int id, string name, int locationDistance, int maxOrders) :
-Customer(id, name, locationDistance, maxOrders) { }
+bool CustomerTable::addOrder(int customerId, int orderId) {
+    if (customerId < 0 || customerId >= (int) customers.size()) return false;
+    Customer &customer = customers[customerId];
+    if (!customer.canMakeOrder()) return false;
+    if (customer.numOrders == customer.ordersCapacity) grow(customer);
+    orderIds[customer.ordersStart + customer.numOrders] = orderId;
+    customer.numOrders++;
+    return true;
+}
+
+/**
+ * @returns the order ids of the customer, which must exist.
+ */
+OrderIdRange CustomerTable::getOrdersIds(int customerId) const {
+    const Customer &customer = customers[customerId];
+    return OrderIdRange(orderIds.data() + customer.ordersStart, customer.numOrders);
+}
+
+void CustomerTable::clear() {
+    customers.clear();
+    orderIds.clear();
+    unused = 0;
+}
 
 /**
- * @returns a pointer to a copy of the customer.
+ * Doubles the customer's region, up to its max orders. A region that isn't the last one moves to the end of the
+ * array first.
  */
-CivilianCustomer *CivilianCustomer::clone() const {
-    return new CivilianCustomer(*this);
+void CustomerTable::grow(Customer &customer) {
+    int capacity = std::min(customer.maxOrders, std::max(MIN_REGION_CAPACITY, customer.ordersCapacity * 2));
+    if (customer.ordersStart + (unsigned long) customer.ordersCapacity != orderIds.size()) {
+        unsigned long start = orderIds.size();
+        orderIds.resize(start + customer.numOrders);
+        std::copy(orderIds.begin() + customer.ordersStart, orderIds.begin() + customer.ordersStart + customer.numOrders,
+                  orderIds.begin() + start);
+        unused += customer.ordersCapacity;
+        customer.ordersStart = start;
+    }
+    orderIds.resize(customer.ordersStart + (unsigned long) capacity);
+    customer.ordersCapacity = capacity;
+    if (unused > orderIds.size() / 2) pack();
+}
+
+/**
+ * Packs the regions in customer id order, dropping the unused slots. Every region keeps its capacity.
+ */
+void CustomerTable::pack() {
+    OrderIdList packed;
+    packed.reserve(orderIds.size() - unused);
+    for (Customer &customer : customers) {
+        unsigned long start = packed.size();
+        packed.insert(packed.end(), orderIds.begin() + customer.ordersStart,
+                      orderIds.begin() + customer.ordersStart + customer.ordersCapacity);
+        customer.ordersStart = start;
+    }
+    orderIds.swap(packed);
+    unused = 0;
 }
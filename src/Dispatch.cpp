@@ -0,0 +1,119 @@
+#include "../include/Dispatch.h"
+
+#include <map>
+#include <algorithm>
+#include <deque>
+#include <limits>
+#include <functional>
+
+#define NO_CLASS (-1)
+
+typedef std::map<int, int, std::greater<int>> DistanceGroups;
+
+DriverMatcher::DriverMatcher(int nodes) : edges(), graph(nodes) { }
+
+/**
+ * Adds an edge and its residual reverse edge.
+ * @returns the index of the edge.
+ */
+int DriverMatcher::addEdge(int from, int to, int capacity, int cost) {
+    graph[from].push_back(edges.size());
+    edges.push_back({to, capacity, cost});
+    graph[to].push_back(edges.size());
+    edges.push_back({from, 0, -cost});
+    return edges.size() - 2;
+}
+
+/**
+ * Successive shortest paths, shortest paths are found with SPFA since residual edges have negative costs.
+ * The graph has a node per distinct distance and per driver class, so this is cheap.
+ */
+void DriverMatcher::minCostMaxFlow(int source, int sink) {
+    const long INFINITE = std::numeric_limits<long>::max();
+    int nodes = graph.size();
+    while (true) {
+        vector<long> distance(nodes, INFINITE);
+        vector<int> through(nodes, -1); // The edge used to reach each node
+        vector<bool> queued(nodes, false);
+        std::deque<int> queue;
+        distance[source] = 0;
+        queue.push_back(source);
+        while (!queue.empty()) {
+            int node = queue.front();
+            queue.pop_front();
+            queued[node] = false;
+            for (int index : graph[node]) {
+                const Edge &edge = edges[index];
+                if (edge.capacity > 0 && distance[node] + edge.cost < distance[edge.to]) {
+                    distance[edge.to] = distance[node] + edge.cost;
+                    through[edge.to] = index;
+                    if (!queued[edge.to]) {
+                        queued[edge.to] = true;
+                        queue.push_back(edge.to);
+                    }
+                }
+            }
+        }
+        if (distance[sink] == INFINITE) return;
+
+        int bottleneck = std::numeric_limits<int>::max();
+        for (int node = sink; node != source; node = edges[through[node] ^ 1].to) {
+            bottleneck = std::min(bottleneck, edges[through[node]].capacity);
+        }
+        for (int node = sink; node != source; node = edges[through[node] ^ 1].to) {
+            edges[through[node]].capacity -= bottleneck;
+            edges[through[node] ^ 1].capacity += bottleneck;
+        }
+    }
+}
+
+/**
+ * @param distances the distances of the awaiting orders, in queue order.
+ * @param classes the free drivers, grouped by class.
+ * @returns for each order, the index of the driver class it's assigned to, or -1 if it's left waiting.
+ * Among orders of the same distance the earlier ones are assigned first.
+ */
+vector<int> DriverMatcher::match(const vector<int> &distances, const vector<DriverClass> &classes) {
+    // Longest distances first, so ties are broken in favor of the orders that are hardest to deliver.
+    DistanceGroups groupOf;
+    for (int distance : distances) groupOf[distance] = 0;
+    int groups = 0;
+    for (DistanceGroups::iterator it = groupOf.begin(); it != groupOf.end(); ++it) it->second = groups++;
+    vector<int> groupSize(groups, 0);
+    for (int distance : distances) groupSize[groupOf[distance]]++;
+
+    const int source = 0, sink = 1, firstGroup = 2, firstClass = 2 + groups;
+    DriverMatcher matcher(firstClass + classes.size());
+    for (int group = 0; group < groups; group++) {
+        matcher.addEdge(source, firstGroup + group, groupSize[group], 0);
+    }
+    for (unsigned long c = 0; c < classes.size(); c++) {
+        matcher.addEdge(firstClass + c, sink, classes[c].count, 0);
+    }
+    vector<vector<int>> edgeOf(groups, vector<int>(classes.size(), -1));
+    for (DistanceGroups::iterator it = groupOf.begin(); it != groupOf.end(); ++it) {
+        for (unsigned long c = 0; c < classes.size(); c++) {
+            if (it->first <= classes[c].maxDistance) {
+                int speed = classes[c].distancePerStep > 0 ? classes[c].distancePerStep : 1;
+                int steps = (it->first + speed - 1) / speed;
+                edgeOf[it->second][c] = matcher.addEdge(firstGroup + it->second, firstClass + c,
+                                                        groupSize[it->second], steps);
+            }
+        }
+    }
+    matcher.minCostMaxFlow(source, sink);
+
+    // The flow on group->class edges says how many orders of each distance go to each class.
+    vector<int> assignment(distances.size(), NO_CLASS);
+    for (unsigned long i = 0; i < distances.size(); i++) {
+        int group = groupOf[distances[i]];
+        for (unsigned long c = 0; c < classes.size() && assignment[i] == NO_CLASS; c++) {
+            int edge = edgeOf[group][c];
+            if (edge != -1 && matcher.edges[edge ^ 1].capacity > 0) { // Reverse capacity is the flow
+                matcher.edges[edge ^ 1].capacity--;
+                assignment[i] = c;
+            }
+        }
+    }
+    return assignment;
+}
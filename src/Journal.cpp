@@ -0,0 +1,228 @@
+#include "../include/Journal.h"
+#include "../include/WareHouse.h"
+#include "../include/CommandCodec.h"
+
+#include <iostream>
+#include <fstream>
+#include <cstring>
+#include <cstdint>
+#include <cerrno>
+#include <fcntl.h>
+#include <unistd.h>
+
+#define JOURNAL_MAGIC "WHJOURN1"
+#define JOURNAL_MAGIC_SIZE 8
+#define JOURNAL_HEADER_SIZE 8 // Payload length and checksum
+
+/**
+ * FNV-1a, enough to tell a torn or garbled record from a whole one.
+ */
+static uint32_t checksum(const char *data, size_t size) {
+    uint32_t hash = 2166136261u;
+    for (size_t i = 0; i < size; i++) {
+        hash = (hash ^ (unsigned char) data[i]) * 16777619u;
+    }
+    return hash;
+}
+
+static uint32_t getUint(const char *data) {
+    uint32_t value;
+    std::memcpy(&value, data, sizeof(value));
+    return value;
+}
+
+/**
+ * Appends the payload's record to the given buffer.
+ * @param payload a command encoded by CommandCodec.
+ * @param record buffer to append the record to.
+ */
+void Journal::frame(const string &payload, string &record) {
+    uint32_t size = payload.size(), sum = checksum(payload.data(), payload.size());
+    record.append((const char *) &size, sizeof(size));
+    record.append((const char *) &sum, sizeof(sum));
+    record += payload;
+}
+
+/**
+ * Opens the journal for appending, a new journal file is created if there's none.
+ * @param path the journal file, replay it before opening it.
+ */
+Journal::Journal(const string &path) :
+    fd(open(path.c_str(), O_WRONLY | O_CREAT | O_APPEND | O_CLOEXEC, 0644)),
+    mutex(),
+    wake(),
+    synced(),
+    pending(),
+    writing(),
+    appended(0),
+    durable(0),
+    syncs(0),
+    closing(false),
+    failed(false),
+    writer()
+{
+    if (fd == -1) return;
+    if (lseek(fd, 0, SEEK_END) == 0) pending.append(JOURNAL_MAGIC, JOURNAL_MAGIC_SIZE);
+    writer = std::thread(&Journal::writeBatches, this);
+}
+
+/**
+ * Queues a command for the writer thread, never waits for the disk.
+ * @param command a command that was performed, as given to WareHouse::execute.
+ */
+void Journal::append(const string &command) {
+    string payload;
+    CommandCodec::encode(command, payload);
+    appendPayload(payload);
+}
+
+/**
+ * Queues an encoded command for the writer thread, never waits for the disk.
+ * @param payload a command that was performed, encoded by CommandCodec.
+ */
+void Journal::appendPayload(const string &payload) {
+    if (fd == -1) return;
+    std::lock_guard<std::mutex> lock(mutex);
+    if (failed) return;
+    bool wasEmpty = pending.empty(); // Otherwise the writer isn't waiting
+    frame(payload, pending);
+    appended++;
+    if (wasEmpty) wake.notify_one();
+}
+
+/**
+ * The writer thread: writes everything that was appended since the last batch, then fsyncs once for all of it.
+ * Stops at the first failed write or fsync, the failed batch isn't acknowledged.
+ */
+void Journal::writeBatches() {
+    std::unique_lock<std::mutex> lock(mutex);
+    while (true) {
+        wake.wait(lock, [this]() { return !pending.empty() || closing; });
+        if (pending.empty()) break; // Closing and everything is written
+        writing.swap(pending);
+        unsigned long batchEnd = appended;
+        lock.unlock();
+
+        const char *data = writing.data();
+        size_t left = writing.size();
+        bool written = true;
+        while (left > 0) {
+            ssize_t count = write(fd, data, left);
+            if (count == -1) {
+                if (errno == EINTR) continue;
+                std::cout << "Failed to write the journal: " << std::strerror(errno) << std::endl;
+                written = false;
+                break;
+            }
+            data += count;
+            left -= count;
+        }
+        bool committed = written && fdatasync(fd) == 0;
+        if (written && !committed) std::cout << "Failed to sync the journal: " << std::strerror(errno) << std::endl;
+        writing.clear();
+
+        lock.lock();
+        if (!committed) {
+            failed = true;
+            pending.clear();
+            synced.notify_all();
+            break;
+        }
+        durable = batchEnd;
+        syncs++;
+        synced.notify_all();
+    }
+}
+
+/**
+ * @returns false if the journal failed, the commands appended since the last acknowledged batch may be lost.
+ */
+bool Journal::flush() {
+    std::unique_lock<std::mutex> lock(mutex);
+    synced.wait(lock, [this]() { return fd == -1 || failed || durable == appended; });
+    return fd != -1 && !failed;
+}
+
+/**
+ * @returns true if the journal file could be opened.
+ */
+bool Journal::isOpen() const {
+    return fd != -1;
+}
+
+/**
+ * @returns true if a write or fsync failed, the journal doesn't take commands anymore.
+ */
+bool Journal::hasFailed() const {
+    std::lock_guard<std::mutex> lock(mutex);
+    return failed;
+}
+
+/**
+ * @returns amount of commands appended so far.
+ */
+unsigned long Journal::getAppended() const {
+    std::lock_guard<std::mutex> lock(mutex);
+    return appended;
+}
+
+/**
+ * @returns amount of fsyncs so far, every fsync commits a whole batch of commands.
+ */
+unsigned long Journal::getSyncs() const {
+    std::lock_guard<std::mutex> lock(mutex);
+    return syncs;
+}
+
+Journal::~Journal() {
+    if (fd == -1) return;
+    {
+        std::lock_guard<std::mutex> lock(mutex);
+        closing = true;
+    }
+    wake.notify_one();
+    writer.join();
+    close(fd);
+}
+
+/**
+ * Performs every command of the journal on the warehouse, without printing their output. A torn record at the
+ * end (the process died while writing it) ends the replay and is cut off the file, so new commands follow the
+ * last whole one.
+ * @param path the journal file, a missing or empty file replays nothing.
+ * @param wareHouse the warehouse to restore, right after its config was loaded.
+ * @returns amount of commands replayed, -1 if the file isn't a journal.
+ */
+long Journal::replay(const string &path, WareHouse &wareHouse) {
+    std::ifstream in(path, std::ios::binary | std::ios::ate);
+    if (!in || in.tellg() <= 0) return 0;
+    string data(in.tellg(), '\0');
+    in.seekg(0);
+    in.read(&data[0], data.size());
+    if (data.size() < JOURNAL_MAGIC_SIZE || data.compare(0, JOURNAL_MAGIC_SIZE, JOURNAL_MAGIC) != 0) {
+        std::cout << "Not a journal file: " << path << std::endl;
+        return -1;
+    }
+
+    std::cout.setstate(std::ios::failbit); // Mutes the replayed commands
+    size_t offset = JOURNAL_MAGIC_SIZE;
+    long replayed = 0;
+    while (offset + JOURNAL_HEADER_SIZE <= data.size() && wareHouse.isOpened()) {
+        uint32_t size = getUint(data.data() + offset);
+        uint32_t sum = getUint(data.data() + offset + 4);
+        const char *payload = data.data() + offset + JOURNAL_HEADER_SIZE;
+        if (size == 0 || size > data.size() - offset - JOURNAL_HEADER_SIZE || checksum(payload, size) != sum) break;
+        if (!CommandCodec::perform(payload, size, wareHouse)) break;
+        offset += JOURNAL_HEADER_SIZE + size;
+        replayed++;
+    }
+    std::cout.clear();
+
+    if (offset < data.size() && wareHouse.isOpened()) {
+        std::cout << "Dropped " << data.size() - offset << " bytes of a torn journal record" << std::endl;
+        if (truncate(path.c_str(), offset) == -1) {
+            std::cout << "Failed to truncate the journal: " << std::strerror(errno) << std::endl;
+        }
+    }
+    return replayed;
+}
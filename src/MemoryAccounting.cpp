@@ -0,0 +1,157 @@
+#include "../include/MemoryAccounting.h"
+
+/**
+ * Prepended to every accounted allocation, padded so the memory after it keeps the allocator's alignment.
+ */
+struct alignas(std::max_align_t) AllocationHeader {
+    MemoryContext *context; // Charged with the allocation
+    size_t bytes; // As requested, without the header
+};
+
+static thread_local MemoryContext *currentContext = nullptr; // nullptr outside of any scope
+
+MemoryUsage::MemoryUsage() : bytes(), objects() { }
+
+MemoryUsage MemoryUsage::operator+(const MemoryUsage &other) const {
+    MemoryUsage sum;
+    for (int i = 0; i < MEMORY_CATEGORY_COUNT; i++) {
+        sum.bytes[i] = bytes[i] + other.bytes[i];
+        sum.objects[i] = objects[i] + other.objects[i];
+    }
+    return sum;
+}
+
+MemoryUsage MemoryUsage::operator-(const MemoryUsage &other) const {
+    MemoryUsage difference;
+    for (int i = 0; i < MEMORY_CATEGORY_COUNT; i++) {
+        difference.bytes[i] = bytes[i] - other.bytes[i];
+        difference.objects[i] = objects[i] - other.objects[i];
+    }
+    return difference;
+}
+
+long MemoryUsage::totalBytes() const {
+    long total = 0;
+    for (long categoryBytes : bytes) total += categoryBytes;
+    return total;
+}
+
+// ####################################################################################### //
+//                                      MemoryContext                                      //
+// ####################################################################################### //
+
+MemoryContext::MemoryContext() : liveBytes(), liveObjects(), references(1) { }
+
+/**
+ * @returns a new empty context, the caller owns its reference and must release() it.
+ */
+MemoryContext *MemoryContext::create() {
+    return new MemoryContext();
+}
+
+/**
+ * @returns the context allocations of this thread are charged to.
+ */
+MemoryContext *MemoryContext::current() {
+    return currentContext != nullptr ? currentContext : unattributed();
+}
+
+/**
+ * @returns the context of whatever is allocated outside of a scope, e.g. a volunteer built before a warehouse
+ * adopts it.
+ */
+MemoryContext *MemoryContext::unattributed() {
+    static MemoryContext *context = new MemoryContext(); // Its reference is never released
+    return context;
+}
+
+void MemoryContext::retain() {
+    references.fetch_add(1, std::memory_order_relaxed);
+}
+
+/**
+ * Drops a reference, the context is deleted with its last one.
+ */
+void MemoryContext::release() {
+    if (references.fetch_sub(1, std::memory_order_acq_rel) == 1) delete this;
+}
+
+/**
+ * @returns the live bytes and objects of every category charged to this context.
+ */
+MemoryUsage MemoryContext::getUsage() const {
+    MemoryUsage usage;
+    for (int i = 0; i < MEMORY_CATEGORY_COUNT; i++) {
+        usage.bytes[i] = liveBytes[i].load(std::memory_order_relaxed);
+        usage.objects[i] = liveObjects[i].load(std::memory_order_relaxed);
+    }
+    return usage;
+}
+
+// ####################################################################################### //
+//                                       MemoryScope                                       //
+// ####################################################################################### //
+
+MemoryScope::MemoryScope(MemoryContext *context) : previous(currentContext) {
+    currentContext = context;
+}
+
+MemoryScope::~MemoryScope() {
+    currentContext = previous;
+}
+
+// ####################################################################################### //
+//                                     MemoryAccounting                                    //
+// ####################################################################################### //
+
+/**
+ * Allocates and charges the current context.
+ * @param bytes the size requested from the allocator.
+ * @param objects amount of objects the allocation holds, 0 for container storage.
+ */
+void *MemoryAccounting::allocate(MemoryCategory category, size_t bytes, long objects) {
+    AllocationHeader *header = static_cast<AllocationHeader*>(::operator new(sizeof(AllocationHeader) + bytes));
+    MemoryContext *context = MemoryContext::current();
+    context->retain();
+    context->liveBytes[(int) category].fetch_add(bytes, std::memory_order_relaxed);
+    if (objects) context->liveObjects[(int) category].fetch_add(objects, std::memory_order_relaxed);
+    header->context = context;
+    header->bytes = bytes;
+    return header + 1;
+}
+
+/**
+ * Frees memory returned by allocate() and credits the context it was charged to.
+ */
+void MemoryAccounting::deallocate(void *memory, MemoryCategory category, long objects) noexcept {
+    if (memory == nullptr) return;
+    AllocationHeader *header = static_cast<AllocationHeader*>(memory) - 1;
+    MemoryContext *context = header->context;
+    context->liveBytes[(int) category].fetch_sub(header->bytes, std::memory_order_relaxed);
+    if (objects) context->liveObjects[(int) category].fetch_sub(objects, std::memory_order_relaxed);
+    ::operator delete(header);
+    context->release();
+}
+
+/**
+ * Moves the charge of memory returned by allocate() to another context, e.g. when a warehouse takes ownership
+ * of an object built outside of its scope.
+ */
+void MemoryAccounting::adopt(void *memory, MemoryCategory category, long objects, MemoryContext *context) {
+    AllocationHeader *header = static_cast<AllocationHeader*>(memory) - 1;
+    MemoryContext *previous = header->context;
+    if (previous == context) return;
+    context->retain();
+    context->liveBytes[(int) category].fetch_add(header->bytes, std::memory_order_relaxed);
+    if (objects) context->liveObjects[(int) category].fetch_add(objects, std::memory_order_relaxed);
+    header->context = context;
+    previous->liveBytes[(int) category].fetch_sub(header->bytes, std::memory_order_relaxed);
+    if (objects) previous->liveObjects[(int) category].fetch_sub(objects, std::memory_order_relaxed);
+    previous->release();
+}
+
+const char *MemoryAccounting::categoryName(MemoryCategory category) {
+    const char *names[] = {"PendingOrders", "InProcessOrders", "CompletedOrders", "OrderPool", "OrderIndexes",
+                           "OrderHistory", "Customers", "CustomerOrderIds", "Volunteers", "Actions", "Names"};
+    return names[(int) category];
+}
@@ -10,9 +10,11 @@ Order::Order(int id, int customerId, int distance) :
     id(id),
     customerId(customerId),
     distance(distance),
-    status(OrderStatus::PENDING),
     collectorId(NO_VOLUNTEER),
-    driverId(NO_VOLUNTEER)
+    driverId(NO_VOLUNTEER),
+    createdStep(0),
+    completedStep(NO_STEP),
+    status(OrderStatus::PENDING)
 { }
 
 /**
@@ -103,3 +105,40 @@ const string Order::toString() const {
 int Order::getDistance() const {
     return distance;
 }
+
+/**
+ * Sets the step the order was placed at.
+ * @param step - the warehouse's step count when the order was placed
+ */
+void Order::setCreatedStep(int step) {
+    createdStep = step;
+}
+
+/**
+ * Sets the step the order was completed at.
+ * @param step - the step at which end the order was delivered
+ */
+void Order::setCompletedStep(int step) {
+    completedStep = step;
+}
+
+/**
+ * @returns the step the order was placed at
+ */
+int Order::getCreatedStep() const {
+    return createdStep;
+}
+
+/**
+ * @returns the step the order was completed at, NO_STEP if it wasn't completed yet
+ */
+int Order::getCompletedStep() const {
+    return completedStep;
+}
+
+/**
+ * @returns amount of steps from placing the order until it was completed, NO_STEP if it wasn't completed yet
+ */
+int Order::getLatency() const {
+    return completedStep == NO_STEP ? NO_STEP : completedStep - createdStep;
+}
@@ -0,0 +1,61 @@
+#include "../include/OrderHistory.h"
+
+#include <algorithm>
+
+#define NO_RECORD UINT32_MAX
+
+OrderHistory::OrderHistory() : steps(), statuses(), volunteers(), previous(), latest() { }
+
+/**
+ * Appends a transition, transitions must be recorded in ascending steps.
+ * @param step amount of steps performed when the order reached the status.
+ * @param volunteerId the collector or driver the order was handed to, NO_VOLUNTEER if none.
+ */
+void OrderHistory::record(int orderId, int step, OrderStatus status, int volunteerId) {
+    if (orderId >= (int) latest.size()) latest.resize(orderId + 1, NO_RECORD);
+    previous.push_back(latest[orderId]);
+    latest[orderId] = steps.size();
+    steps.push_back(step);
+    statuses.push_back(status);
+    volunteers.push_back(volunteerId);
+}
+
+/**
+ * Reconstructs an order as it was after the given amount of steps.
+ * @param order the order as it is now.
+ * @param past set to the order as it was, if it was placed by then.
+ * @returns false if the order was placed after the step.
+ */
+bool OrderHistory::stateAt(const Order &order, int step, Order &past) const {
+    if (order.getId() >= (int) latest.size()) return false;
+    // Records from happened onwards weren't there yet.
+    uint32_t happened = std::upper_bound(steps.begin(), steps.end(), step) - steps.begin();
+    uint32_t current = latest[order.getId()];
+    while (current != NO_RECORD && current >= happened) current = previous[current];
+    if (current == NO_RECORD) return false;
+
+    past = order;
+    past.setStatus(statuses[current]);
+    past.setCollectorId(NO_VOLUNTEER);
+    past.setDriverId(NO_VOLUNTEER);
+    past.setCompletedStep(statuses[current] == OrderStatus::COMPLETED ? steps[current] : NO_STEP);
+    for (; current != NO_RECORD; current = previous[current]) {
+        if (statuses[current] == OrderStatus::COLLECTING) past.setCollectorId(volunteers[current]);
+        if (statuses[current] == OrderStatus::DELIVERING) past.setDriverId(volunteers[current]);
+    }
+    return true;
+}
+
+void OrderHistory::clear() {
+    steps.clear();
+    statuses.clear();
+    volunteers.clear();
+    previous.clear();
+    latest.clear();
+}
+
+unsigned long OrderHistory::memoryUsage() const {
+    return steps.capacity() * sizeof(int32_t) + statuses.capacity() * sizeof(OrderStatus) +
+           volunteers.capacity() * sizeof(int32_t) + previous.capacity() * sizeof(uint32_t) +
+           latest.capacity() * sizeof(uint32_t);
+}
@@ -0,0 +1,176 @@
+#include "../include/OrderIndex.h"
+
+#include <algorithm>
+#include <climits>
+
+#define NO_POSITION (-1)
+
+OrderQuery::OrderQuery() :
+    byStatus(false),
+    status(OrderStatus::PENDING),
+    customerId(ANY_CUSTOMER),
+    collectorId(NO_VOLUNTEER),
+    driverId(NO_VOLUNTEER),
+    minDistance(INT_MIN),
+    maxDistance(INT_MAX),
+    limit(NO_LIMIT)
+{ }
+
+/**
+ * @returns true if the order satisfies all the predicates, the limit isn't checked.
+ */
+bool OrderQuery::matches(const Order &order) const {
+    return (!byStatus || order.getStatus() == status) &&
+           (customerId == ANY_CUSTOMER || order.getCustomerId() == customerId) &&
+           (collectorId == NO_VOLUNTEER || order.getCollectorId() == collectorId) &&
+           (driverId == NO_VOLUNTEER || order.getDriverId() == driverId) &&
+           order.getDistance() >= minDistance && order.getDistance() <= maxDistance;
+}
+
+string OrderQuery::toString() const {
+    const char *statuses[] = {"Pending", "Collecting", "Delivering", "Completed"};
+    string output;
+    if (byStatus) output += " status=" + string(statuses[(int) status]);
+    if (customerId != ANY_CUSTOMER) output += " customer=" + std::to_string(customerId);
+    if (collectorId != NO_VOLUNTEER) output += " collector=" + std::to_string(collectorId);
+    if (driverId != NO_VOLUNTEER) output += " driver=" + std::to_string(driverId);
+    if (minDistance == maxDistance) {
+        output += " distance=" + std::to_string(minDistance);
+    } else {
+        if (minDistance != INT_MIN) output += " distance>=" + std::to_string(minDistance);
+        if (maxDistance != INT_MAX) output += " distance<=" + std::to_string(maxDistance);
+    }
+    if (limit != NO_LIMIT) output += " limit " + std::to_string(limit);
+    return output.empty() ? output : output.substr(1);
+}
+
+OrderIndex::OrderIndex() :
+    byStatus(ORDER_STATUS_COUNT),
+    statusPosition(),
+    byCustomer(),
+    byVolunteer(),
+    byDistance()
+{ }
+
+/**
+ * Indexes a newly placed (pending) order.
+ */
+void OrderIndex::add(const Order &order) {
+    int id = order.getId();
+    if (id >= (int) statusPosition.size()) statusPosition.resize(id + 1, NO_POSITION);
+    IndexedOrders &bucket = byStatus[(int) order.getStatus()];
+    statusPosition[id] = bucket.size();
+    bucket.push_back(id);
+    if (order.getCustomerId() >= (int) byCustomer.size()) byCustomer.resize(order.getCustomerId() + 1);
+    byCustomer[order.getCustomerId()].push_back(id);
+    byDistance[order.getDistance()].push_back(id);
+}
+
+/**
+ * Indexes the order under the collector or driver it was just handed to.
+ */
+void OrderIndex::assign(const Order &order, int volunteerId) {
+    if (volunteerId >= (int) byVolunteer.size()) byVolunteer.resize(volunteerId + 1);
+    byVolunteer[volunteerId].push_back(order.getId());
+}
+
+/**
+ * Moves the order from the bucket of its previous status to the bucket of its current one.
+ */
+void OrderIndex::changeStatus(const Order &order, OrderStatus previous) {
+    if (order.getStatus() == previous) return;
+    int id = order.getId();
+    IndexedOrders &from = byStatus[(int) previous];
+    int position = statusPosition[id];
+    from[position] = from.back();
+    statusPosition[from[position]] = position;
+    from.pop_back();
+    IndexedOrders &to = byStatus[(int) order.getStatus()];
+    statusPosition[id] = to.size();
+    to.push_back(id);
+}
+
+/**
+ * Finds the orders matching the query. Only the orders of the smallest index list the query filters by are
+ * read, the rest of the predicates are checked on each of them.
+ * @param orders the orders this index was built over.
+ * @param matched set to amount of orders matching the query, regardless of its limit.
+ * @returns the ids of the matching orders, ascending, at most query.limit of them.
+ */
+vector<int> OrderIndex::query(const OrderQuery &query, const OrderPool &orders, int &matched) const {
+    static const IndexedOrders noOrders;
+    const IndexedOrders *candidates = nullptr;
+    unsigned long candidatesCount = ULONG_MAX;
+    auto consider = [&candidates, &candidatesCount](const IndexedOrders &list) {
+        if (list.size() < candidatesCount) {
+            candidates = &list;
+            candidatesCount = list.size();
+        }
+    };
+    auto listOf = [](const IndexedOrderLists &lists, int key) -> const IndexedOrders& {
+        return key >= 0 && key < (int) lists.size() ? lists[key] : noOrders;
+    };
+    if (query.byStatus) consider(byStatus[(int) query.status]);
+    if (query.customerId != ANY_CUSTOMER) consider(listOf(byCustomer, query.customerId));
+    if (query.collectorId != NO_VOLUNTEER) consider(listOf(byVolunteer, query.collectorId));
+    if (query.driverId != NO_VOLUNTEER) consider(listOf(byVolunteer, query.driverId));
+
+    vector<int> result;
+    matched = 0;
+    if (query.minDistance > query.maxDistance) return result; // No distance is in the range
+
+    auto from = byDistance.lower_bound(query.minDistance);
+    auto to = query.maxDistance == INT_MAX ? byDistance.end() : byDistance.upper_bound(query.maxDistance);
+    bool byDistanceRange = false;
+    if (query.minDistance != INT_MIN || query.maxDistance != INT_MAX) {
+        unsigned long inRange = 0;
+        for (auto it = from; it != to && inRange < candidatesCount; ++it) inRange += it->second.size();
+        if (inRange < candidatesCount) {
+            byDistanceRange = true;
+            candidatesCount = inRange;
+        }
+    }
+
+    auto check = [&query, &orders, &result](int orderId) {
+        const Order *order = orders.find(orderId);
+        if (order && query.matches(*order)) result.push_back(orderId);
+    };
+    if (byDistanceRange) {
+        for (auto it = from; it != to; ++it) {
+            for (int orderId : it->second) check(orderId);
+        }
+    } else if (candidates) {
+        for (int orderId : *candidates) check(orderId);
+    } else {
+        for (int orderId = 0; orderId < orders.size(); orderId++) check(orderId);
+    }
+
+    matched = result.size();
+    if (query.limit != NO_LIMIT && (int) result.size() > query.limit) { // Only the printed ones are sorted
+        std::partial_sort(result.begin(), result.begin() + query.limit, result.end());
+        result.resize(query.limit);
+    } else {
+        std::sort(result.begin(), result.end());
+    }
+    return result;
+}
+
+void OrderIndex::clear() {
+    for (IndexedOrders &bucket : byStatus) bucket.clear();
+    statusPosition.clear();
+    byCustomer.clear();
+    byVolunteer.clear();
+    byDistance.clear();
+}
+
+/**
+ * @returns amount of bytes reserved by the indexes, the map's nodes are estimated.
+ */
+unsigned long OrderIndex::memoryUsage() const {
+    unsigned long bytes = statusPosition.capacity() * sizeof(int);
+    for (const IndexedOrders &bucket : byStatus) bytes += bucket.capacity() * sizeof(int) + sizeof(bucket);
+    for (const IndexedOrders &list : byCustomer) bytes += list.capacity() * sizeof(int) + sizeof(list);
+    for (const IndexedOrders &list : byVolunteer) bytes += list.capacity() * sizeof(int) + sizeof(list);
+    for (const auto &entry : byDistance) bytes += entry.second.capacity() * sizeof(int) + 4 * sizeof(void*) + sizeof(entry);
+    return bytes;
+}
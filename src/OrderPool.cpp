@@ -0,0 +1,124 @@
+#include "../include/OrderPool.h"
+
+#include <type_traits>
+#include <algorithm>
+
+#define ORDER_POOL_CHUNK 4096
+#define NO_ORDER_ID (-1)
+
+static_assert(std::is_trivially_copyable<Order>::value, "orders are copied as raw memory");
+static_assert(sizeof(Order) == 32, "an order is expected to take 32 bytes");
+
+OrderPool::OrderPool() : chunks(), count(0) { }
+
+OrderPool::OrderPool(const OrderPool &other) : chunks(), count(0) {
+    copyFrom(other);
+}
+
+/**
+ * Shares the other pool's chunks, copying only the ones this pool may change: the chunks holding the given
+ * orders and the last chunk if orders can still be added to it. Used for forks, the other pool must not change
+ * any order outside of changingIds either - the orders of the shared chunks are completed.
+ * @param changingIds the orders that aren't completed yet.
+ */
+OrderPool::OrderPool(const OrderPool &other, const vector<int> &changingIds) :
+    chunks(other.chunks),
+    count(other.count)
+{
+    vector<bool> copied(chunks.size(), false);
+    if (!chunks.empty() && chunks.back()->size() < ORDER_POOL_CHUNK) copied.back() = true;
+    for (int id : changingIds) copied[id / ORDER_POOL_CHUNK] = true;
+    for (unsigned long i = 0; i < chunks.size(); i++) {
+        if (copied[i]) chunks[i] = copyChunk(*chunks[i]);
+    }
+}
+
+OrderPool::OrderPool(OrderPool &&other) noexcept : chunks(std::move(other.chunks)), count(other.count) {
+    other.chunks.clear();
+    other.count = 0;
+}
+
+OrderPool &OrderPool::operator=(const OrderPool &other) {
+    if (this != &other) {
+        clear();
+        copyFrom(other);
+    }
+    return *this;
+}
+
+OrderPool &OrderPool::operator=(OrderPool &&other) noexcept {
+    if (this != &other) {
+        chunks.swap(other.chunks);
+        std::swap(count, other.count);
+        other.clear();
+    }
+    return *this;
+}
+
+/**
+ * Copies all of the other pool's chunks.
+ */
+void OrderPool::copyFrom(const OrderPool &other) {
+    chunks.reserve(other.chunks.size());
+    for (const shared_ptr<OrderChunk> &chunk : other.chunks) chunks.push_back(copyChunk(*chunk));
+    count = other.count;
+}
+
+/**
+ * @returns a new chunk holding a copy of the orders, it reserves a whole chunk so adding orders never moves it.
+ */
+shared_ptr<OrderChunk> OrderPool::copyChunk(const OrderChunk &chunk) {
+    shared_ptr<OrderChunk> copy = std::allocate_shared<OrderChunk>(
+        AccountedAllocator<OrderChunk, MemoryCategory::OrderPool>());
+    copy->reserve(ORDER_POOL_CHUNK);
+    copy->insert(copy->end(), chunk.begin(), chunk.end());
+    return copy;
+}
+
+/**
+ * Stores a copy of the order at its id. Ids normally arrive in order, ids that were skipped are left as holes
+ * that find() doesn't return.
+ * @param order the order to store, no order with the same id may be stored already.
+ * @returns the stored order.
+ */
+Order &OrderPool::add(const Order &order) {
+    const Order hole(NO_ORDER_ID, NO_ORDER_ID, 0);
+    while (count <= order.getId()) {
+        if (count % ORDER_POOL_CHUNK == 0) chunks.push_back(copyChunk(OrderChunk()));
+        chunks.back()->push_back(hole);
+        count++;
+    }
+    Order &stored = (*chunks[order.getId() / ORDER_POOL_CHUNK])[order.getId() % ORDER_POOL_CHUNK];
+    stored = order;
+    return stored;
+}
+
+/**
+ * @returns the order with the given id, nullptr if there's none. O(1).
+ */
+Order *OrderPool::find(int orderId) const {
+    if (orderId < 0 || orderId >= count) return nullptr;
+    const Order &order = (*chunks[orderId / ORDER_POOL_CHUNK])[orderId % ORDER_POOL_CHUNK];
+    return order.getId() == NO_ORDER_ID ? nullptr : const_cast<Order*>(&order);
+}
+
+int OrderPool::size() const {
+    return count;
+}
+
+/**
+ * Removes all the orders, pointers to them become invalid.
+ */
+void OrderPool::clear() {
+    chunks.clear();
+    count = 0;
+}
+
+/**
+ * @returns amount of bytes the pool reserved for orders.
+ */
+unsigned long OrderPool::memoryUsage() const {
+    unsigned long bytes = chunks.capacity() * sizeof(shared_ptr<OrderChunk>);
+    for (const shared_ptr<OrderChunk> &chunk : chunks) bytes += sizeof(OrderChunk) + chunk->capacity() * sizeof(Order);
+    return bytes;
+}
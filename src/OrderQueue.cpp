@@ -0,0 +1,46 @@
+#include "../include/OrderQueue.h"
+
+/**
+ * Starts with a dummy node, so producers and the consumer never touch the same pointer.
+ */
+OrderQueue::OrderQueue() : head(nullptr), tail(new Node(-1)) {
+    head.store(tail, std::memory_order_relaxed);
+}
+
+/**
+ * Enqueues an order request.
+ * @param customerId the customer placing the order, validated only when the order is drained.
+ */
+void OrderQueue::push(int customerId) {
+    Node *node = new Node(customerId);
+    Node *previous = head.exchange(node, std::memory_order_acq_rel);
+    // Between the exchange and this store the consumer sees the queue as empty, it'll pick it up next drain.
+    previous->next.store(node, std::memory_order_release);
+}
+
+/**
+ * Dequeues the oldest order request.
+ * @param customerId set to the customer of the dequeued request.
+ * @returns false if there was nothing to dequeue.
+ */
+bool OrderQueue::pop(int &customerId) {
+    Node *next = tail->next.load(std::memory_order_acquire);
+    if (next == nullptr) {
+        return false;
+    }
+    customerId = next->customerId;
+    delete tail;
+    tail = next; // next becomes the new dummy
+    return true;
+}
+
+/**
+ * Frees the remaining requests, producers must have stopped pushing.
+ */
+OrderQueue::~OrderQueue() {
+    while (tail) {
+        Node *next = tail->next.load(std::memory_order_relaxed);
+        delete tail;
+        tail = next;
+    }
+}
@@ -0,0 +1,130 @@
+#include "../include/OrderTracer.h"
+
+#include <algorithm>
+
+/**
+ * Opens the trace file and writes the JSON header.
+ * @param path the trace file to (over)write.
+ * @param capacity amount of events buffered between flushes.
+ */
+OrderTracer::OrderTracer(const string &path, unsigned long capacity) :
+    events(capacity),
+    head(0),
+    dropped(0),
+    out(path),
+    firstEvent(true),
+    openSlices(),
+    lastTs(0)
+{
+    out << "{\"displayTimeUnit\":\"ms\",\"traceEvents\":[\n";
+}
+
+/**
+ * Records a single transition of an order, safe to call from several threads at once.
+ * @param step the step in which the transition happened.
+ * @param orderId the order that transitioned.
+ * @param phase the phase the order entered.
+ * @param volunteerId the volunteer responsible for the phase (collector/driver).
+ */
+void OrderTracer::record(int step, int orderId, TracePhase phase, int volunteerId) {
+    unsigned long slot = head.fetch_add(1, std::memory_order_relaxed);
+    if (slot >= events.size()) {
+        dropped.fetch_add(1, std::memory_order_relaxed);
+        return;
+    }
+    TraceEvent &event = events[slot];
+    event.step = step;
+    event.orderId = orderId;
+    event.volunteerId = volunteerId;
+    event.phase = phase;
+}
+
+static const char *phaseName(TracePhase phase) {
+    switch (phase) {
+        case TracePhase::Pending: return "Pending";
+        case TracePhase::Collecting: return "Collecting";
+        case TracePhase::AwaitingDriver: return "Awaiting driver";
+        case TracePhase::Delivering: return "Delivering";
+        default: return "Completed";
+    }
+}
+
+/**
+ * Ends the order's open slice, if it has one.
+ */
+void OrderTracer::endSlice(int orderId, long ts) {
+    if ((unsigned long) orderId >= openSlices.size() || !openSlices[orderId]) return;
+    out << (firstEvent ? "" : ",\n") << "{\"ph\":\"E\",\"pid\":1,\"tid\":" << orderId << ",\"ts\":" << ts << "}";
+    firstEvent = false;
+    openSlices[orderId] = false;
+}
+
+/**
+ * Ends the previous phase of the order and begins the new one, completion is an instant event.
+ */
+void OrderTracer::writeEvent(const TraceEvent &event) {
+    long ts = event.step * 1000L;
+    lastTs = std::max(lastTs, ts);
+    endSlice(event.orderId, ts);
+    if ((unsigned long) event.orderId >= openSlices.size()) openSlices.resize(event.orderId + 1, false);
+    if (event.phase == TracePhase::Pending) {
+        out << (firstEvent ? "" : ",\n") << "{\"name\":\"thread_name\",\"ph\":\"M\",\"pid\":1,\"tid\":"
+            << event.orderId << ",\"args\":{\"name\":\"Order " << event.orderId << "\"}}";
+        firstEvent = false;
+    }
+    out << (firstEvent ? "" : ",\n") << "{\"name\":\"" << phaseName(event.phase) << "\",\"ph\":\""
+        << (event.phase == TracePhase::Completed ? "i\",\"s\":\"t" : "B")
+        << "\",\"pid\":1,\"tid\":" << event.orderId << ",\"ts\":" << ts << ",\"args\":{\"step\":" << event.step;
+    firstEvent = false;
+    if (event.phase == TracePhase::Collecting || event.phase == TracePhase::AwaitingDriver) {
+        out << ",\"collector\":" << event.volunteerId;
+    } else if (event.phase == TracePhase::Delivering || event.phase == TracePhase::Completed) {
+        out << ",\"driver\":" << event.volunteerId;
+    }
+    out << "}}";
+    openSlices[event.orderId] = event.phase != TracePhase::Completed;
+}
+
+/**
+ * Writes all buffered events to the file and empties the buffer.
+ * @note Must not run concurrently with record().
+ */
+void OrderTracer::flush() {
+    unsigned long size = std::min(head.load(std::memory_order_acquire), (unsigned long) events.size());
+    for (unsigned long i = 0; i < size; i++) {
+        writeEvent(events[i]);
+    }
+    head.store(0, std::memory_order_release);
+    out.flush();
+}
+
+void OrderTracer::flushIfFull() {
+    if (head.load(std::memory_order_relaxed) >= events.size() / 2) {
+        flush();
+    }
+}
+
+/**
+ * @returns true if the trace file could be opened.
+ */
+bool OrderTracer::isOpen() const {
+    return out.is_open();
+}
+
+/**
+ * @returns the amount of events that didn't fit in the buffer.
+ */
+unsigned long OrderTracer::getDropped() const {
+    return dropped.load(std::memory_order_relaxed);
+}
+
+/**
+ * Flushes the remaining events, ends the slices whose end was dropped and closes the JSON document.
+ */
+OrderTracer::~OrderTracer() {
+    flush();
+    for (unsigned long orderId = 0; orderId < openSlices.size(); orderId++) {
+        endSlice(orderId, lastTs);
+    }
+    out << "\n]}\n";
+}
@@ -0,0 +1,225 @@
+#include "../include/ReadView.h"
+#include "../include/Customer.h"
+#include "../include/Volunteer.h"
+
+#include <algorithm>
+
+#define ORDER_CHUNK 4096
+#define CUSTOMER_CHUNK 256
+#define NO_ORDER_RECORD (-1)
+#define NO_CUSTOMER_RECORD (-1)
+
+/**
+ * An empty view, version 0.
+ */
+ReadView::ReadView() : version(0), step(0), orderCount(0), orders(), customers(), volunteers() { }
+
+/**
+ * @returns the version of the view, increased by one with every publish.
+ */
+long ReadView::getVersion() const {
+    return version;
+}
+
+/**
+ * @returns the amount of steps which were performed when the view was published.
+ */
+int ReadView::getStep() const {
+    return step;
+}
+
+/**
+ * @returns the amount of orders placed when the view was published.
+ */
+int ReadView::getOrderCount() const {
+    return orderCount;
+}
+
+/**
+ * Builds the next view, sharing all the chunks which weren't changed with the previous one.
+ * @param previous the last published view, nullptr to build a view from scratch.
+ * @param version the new view's version.
+ * @param step the warehouse's step count.
+ * @param changedOrders orders that were added or changed since the previous view.
+ * @param customers all the customers.
+ * @param changedCustomers ids of the customers that were added or changed since the previous view.
+ * @param volunteers all current volunteers, in id order.
+ * @param changedVolunteers ids of the volunteers that were added or changed since the previous view, they are
+ * cloned. The others are shared with the previous view.
+ * @returns the new view.
+ */
+shared_ptr<const ReadView> ReadView::publish(const shared_ptr<const ReadView> &previous, long version, int step,
+                                             const vector<const Order*> &changedOrders,
+                                             const CustomerTable &customers,
+                                             const vector<int> &changedCustomers,
+                                             const VolunteerList &volunteers,
+                                             const vector<int> &changedVolunteers) {
+    shared_ptr<ReadView> view = std::make_shared<ReadView>();
+    if (previous) {
+        view->orders = previous->orders;
+        view->customers = previous->customers;
+        view->orderCount = previous->orderCount;
+    }
+    view->version = version;
+    view->step = step;
+
+    // Copy on write - a shared chunk is copied the first time one of its records changes.
+    vector<OrderChunk*> writableOrders(view->orders.size(), nullptr);
+    for (const Order *order : changedOrders) {
+        OrderRecord &record = view->writableOrder(order->getId(), writableOrders);
+        record.id = order->getId();
+        record.customerId = order->getCustomerId();
+        record.distance = order->getDistance();
+        record.collectorId = order->getCollectorId();
+        record.driverId = order->getDriverId();
+        record.status = order->getStatus();
+        view->orderCount = std::max(view->orderCount, order->getId() + 1);
+    }
+
+    // Customers only keep the head of their orders list, so their chunks stay cheap to copy.
+    vector<CustomerChunk*> writableCustomers(view->customers.size(), nullptr);
+    for (int customerId : changedCustomers) {
+        const Customer &customer = customers[customerId];
+        unsigned long index = customerId / CUSTOMER_CHUNK;
+        while (view->customers.size() <= index) {
+            CustomerRecord empty = {NO_CUSTOMER_RECORD, 0, 0, NO_ORDER_RECORD};
+            CustomerChunk *chunk = new CustomerChunk(CUSTOMER_CHUNK, empty);
+            view->customers.push_back(shared_ptr<const CustomerChunk>(chunk));
+            writableCustomers.push_back(chunk);
+        }
+        if (writableCustomers[index] == nullptr) {
+            writableCustomers[index] = new CustomerChunk(*view->customers[index]);
+            view->customers[index] = shared_ptr<const CustomerChunk>(writableCustomers[index]);
+        }
+        CustomerRecord &record = (*writableCustomers[index])[customerId % CUSTOMER_CHUNK];
+        OrderIdRange ordersId = customers.getOrdersIds(customerId);
+        int linked = record.id == NO_CUSTOMER_RECORD ? 0 : record.numOrders;
+        for (int i = linked; i < ordersId.size(); i++) {
+            view->writableOrder(ordersId[i], writableOrders).previousOfCustomer = i > 0 ? ordersId[i - 1] : NO_ORDER_RECORD;
+        }
+        record.id = customerId;
+        record.maxOrders = customer.getMaxOrders();
+        record.numOrders = ordersId.size();
+        record.lastOrderId = ordersId.empty() ? NO_ORDER_RECORD : ordersId.back();
+    }
+
+    // Both lists are in id order, retired volunteers are left out of the new view.
+    vector<int> changed(changedVolunteers);
+    std::sort(changed.begin(), changed.end());
+    unsigned long nextChanged = 0, nextShared = 0;
+    unsigned long sharedCount = previous ? previous->volunteers.size() : 0;
+    view->volunteers.reserve(volunteers.size());
+    for (const Volunteer *volunteer : volunteers) {
+        int id = volunteer->getId();
+        while (nextChanged < changed.size() && changed[nextChanged] < id) nextChanged++;
+        while (nextShared < sharedCount && previous->volunteers[nextShared]->getId() < id) nextShared++;
+        bool isChanged = nextChanged < changed.size() && changed[nextChanged] == id;
+        if (!isChanged && nextShared < sharedCount && previous->volunteers[nextShared]->getId() == id) {
+            view->volunteers.push_back(previous->volunteers[nextShared]);
+        } else {
+            view->volunteers.push_back(shared_ptr<const Volunteer>(volunteer->clone()));
+        }
+    }
+    return view;
+}
+
+/**
+ * @returns the record of the order in a chunk owned by this (unpublished) view, copying the chunk if needed.
+ */
+ReadView::OrderRecord &ReadView::writableOrder(int orderId, vector<OrderChunk*> &writable) {
+    unsigned long index = orderId / ORDER_CHUNK;
+    while (orders.size() <= index) {
+        OrderRecord empty = {NO_ORDER_RECORD, 0, 0, NO_VOLUNTEER, NO_VOLUNTEER, NO_ORDER_RECORD, OrderStatus::PENDING};
+        OrderChunk *chunk = new OrderChunk(ORDER_CHUNK, empty);
+        orders.push_back(shared_ptr<const OrderChunk>(chunk));
+        writable.push_back(chunk);
+    }
+    if (writable[index] == nullptr) {
+        writable[index] = new OrderChunk(*orders[index]);
+        orders[index] = shared_ptr<const OrderChunk>(writable[index]);
+    }
+    return (*writable[index])[orderId % ORDER_CHUNK];
+}
+
+const ReadView::OrderRecord *ReadView::findOrder(int orderId) const {
+    if (orderId < 0 || (unsigned long) orderId / ORDER_CHUNK >= orders.size()) return nullptr;
+    const OrderRecord &record = (*orders[orderId / ORDER_CHUNK])[orderId % ORDER_CHUNK];
+    return record.id == NO_ORDER_RECORD ? nullptr : &record;
+}
+
+const ReadView::CustomerRecord *ReadView::findCustomer(int customerId) const {
+    if (customerId < 0 || (unsigned long) customerId / CUSTOMER_CHUNK >= customers.size()) return nullptr;
+    const CustomerRecord &record = (*customers[customerId / CUSTOMER_CHUNK])[customerId % CUSTOMER_CHUNK];
+    return record.id == NO_CUSTOMER_RECORD ? nullptr : &record;
+}
+
+/**
+ * @param orderId the order to describe.
+ * @returns the order's description, as printed by orderStatus.
+ */
+string ReadView::orderStatus(int orderId) const {
+    const OrderRecord *record = findOrder(orderId);
+    if (record == nullptr) {
+        return "Order doesn’t exist";
+    }
+    Order order(record->id, record->customerId, record->distance);
+    order.setStatus(record->status);
+    order.setCollectorId(record->collectorId);
+    order.setDriverId(record->driverId);
+    return order.toString();
+}
+
+/**
+ * @param customerId the customer to describe.
+ * @returns the customer's orders and how many more it may place, as printed by customerStatus.
+ */
+string ReadView::customerStatus(int customerId) const {
+    const CustomerRecord *customer = findCustomer(customerId);
+    if (customer == nullptr) {
+        return "Customer doesn’t exist";
+    }
+    // Walk the customer's orders list from the newest, then print from the oldest.
+    vector<int> ordersId(customer->numOrders);
+    int orderId = customer->lastOrderId;
+    for (int i = customer->numOrders - 1; i >= 0; i--) {
+        ordersId[i] = orderId;
+        const OrderRecord *order = findOrder(orderId);
+        orderId = order == nullptr ? NO_ORDER_RECORD : order->previousOfCustomer;
+    }
+    string output = "CustomerID: " + std::to_string(customerId) + "\n";
+    for (int id : ordersId) {
+        const OrderRecord *order = findOrder(id);
+        if (order == nullptr) {
+            output += "Error retrieving order details for OrderID: " + std::to_string(id) + "\n";
+            continue;
+        }
+        output += "OrderID: " + std::to_string(id) + "\nOrderStatus: ";
+        switch (order->status) {
+            case OrderStatus::PENDING: output += "Pending\n"; break;
+            case OrderStatus::COLLECTING: output += "Collecting\n"; break;
+            case OrderStatus::DELIVERING: output += "Delivering\n"; break;
+            case OrderStatus::COMPLETED: output += "Completed\n"; break;
+            default: output += "Unknown\n";
+        }
+    }
+    output += "numOrdersLeft: " + std::to_string(customer->maxOrders - customer->numOrders);
+    return output;
+}
+
+/**
+ * @param volunteerId the volunteer to describe.
+ * @returns the volunteer's description, as printed by volunteerStatus.
+ */
+string ReadView::volunteerStatus(int volunteerId) const {
+    // Volunteers are kept in id order, retired ones are missing.
+    unsigned long low = 0, high = volunteers.size();
+    while (low < high) {
+        unsigned long middle = (low + high) / 2;
+        if (volunteers[middle]->getId() < volunteerId) low = middle + 1;
+        else high = middle;
+    }
+    if (low == volunteers.size() || volunteers[low]->getId() != volunteerId) {
+        return "Volunteer doesn’t exist";
+    }
+    return volunteers[low]->toString();
+}
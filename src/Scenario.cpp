@@ -0,0 +1,126 @@
+#include "../include/Scenario.h"
+#include "../include/WareHouse.h"
+#include "../include/Volunteer.h"
+
+#include <algorithm>
+
+ScenarioVariant::ScenarioVariant() :
+    name("base"),
+    collectors(0),
+    collectorCoolDown(0),
+    drivers(0),
+    driverMaxDistance(0),
+    driverDistancePerStep(0),
+    volunteerNameId(0),
+    orders(0)
+{ }
+
+ScenarioOutcome::ScenarioOutcome() : completed(0), backlog(0), meanLatency(-1) { }
+
+ScenarioRunner::ScenarioRunner() :
+    mutex(),
+    wake(),
+    finished(),
+    wareHouse(nullptr),
+    steps(0),
+    variants(nullptr),
+    outcomes(nullptr),
+    next(0),
+    done(0),
+    stopping(false),
+    workers()
+{
+    unsigned int count = std::max(1u, std::thread::hardware_concurrency());
+    for (unsigned int i = 0; i < count; i++) {
+        workers.push_back(std::thread(&ScenarioRunner::work, this));
+    }
+}
+
+/**
+ * Runs every variant's scenario for the given amount of steps on the workers, in parallel.
+ * @returns the outcomes, in the order of the variants.
+ */
+vector<ScenarioOutcome> ScenarioRunner::run(const WareHouse &wareHouse, int steps,
+                                            const vector<ScenarioVariant> &variants) {
+    vector<ScenarioOutcome> outcomes(variants.size());
+    if (variants.empty()) return outcomes;
+    std::unique_lock<std::mutex> lock(mutex);
+    this->wareHouse = &wareHouse;
+    this->steps = steps;
+    this->variants = &variants;
+    this->outcomes = &outcomes;
+    next = 0;
+    done = 0;
+    wake.notify_all();
+    finished.wait(lock, [this]() { return done == this->variants->size(); });
+    this->wareHouse = nullptr;
+    this->variants = nullptr;
+    this->outcomes = nullptr;
+    return outcomes;
+}
+
+/**
+ * A worker: takes the current run's scenarios one at a time until none is left, then waits for the next run.
+ */
+void ScenarioRunner::work() {
+    std::unique_lock<std::mutex> lock(mutex);
+    while (true) {
+        wake.wait(lock, [this]() { return stopping || (variants != nullptr && next < variants->size()); });
+        if (stopping) break;
+        unsigned long v = next++;
+        lock.unlock();
+        ScenarioOutcome outcome = runScenario(*wareHouse, steps, (*variants)[v]);
+        lock.lock();
+        (*outcomes)[v] = outcome;
+        done++;
+        if (done == variants->size()) finished.notify_one();
+    }
+}
+
+ScenarioRunner::~ScenarioRunner() {
+    {
+        std::lock_guard<std::mutex> lock(mutex);
+        stopping = true;
+    }
+    wake.notify_all();
+    for (std::thread &worker : workers) worker.join();
+}
+
+/**
+ * Forks the warehouse, applies the variant's changes to the fork and steps it.
+ */
+ScenarioOutcome ScenarioRunner::runScenario(const WareHouse &wareHouse, int steps, const ScenarioVariant &variant) {
+    WareHouse scenario = wareHouse.fork();
+    for (int i = 0; i < variant.collectors; i++) {
+        scenario.addVolunteer(new CollectorVolunteer(scenario.getVolunteerCount(), variant.volunteerNameId,
+                                                     variant.collectorCoolDown));
+    }
+    for (int i = 0; i < variant.drivers; i++) {
+        scenario.addVolunteer(new DriverVolunteer(scenario.getVolunteerCount(), variant.volunteerNameId,
+                                                  variant.driverMaxDistance, variant.driverDistancePerStep));
+    }
+    int injected = 0;
+    bool placing = true;
+    while (injected < variant.orders && placing) { // Stops once no customer can order anymore
+        placing = false;
+        for (int id = 0; id < scenario.getCustomerCount() && injected < variant.orders; id++) {
+            if (scenario.placeOrder(id)) {
+                injected++;
+                placing = true;
+            }
+        }
+    }
+    for (int i = 0; i < steps; i++) {
+        scenario.step();
+    }
+
+    ScenarioOutcome outcome;
+    outcome.completed = scenario.getCompletedOrders().size();
+    outcome.backlog = scenario.getPendingOrders().size() + scenario.getInProcessOrders().size();
+    if (outcome.completed > 0) {
+        long total = 0;
+        for (const Order *order : scenario.getCompletedOrders()) total += order->getLatency();
+        outcome.meanLatency = (double) total / outcome.completed;
+    }
+    return outcome;
+}
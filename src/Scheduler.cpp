@@ -0,0 +1,145 @@
+#include "../include/Scheduler.h"
+
+#include <algorithm>
+
+// ####################################################################################### //
+//                                        Scheduler                                        //
+// ####################################################################################### //
+
+Scheduler::Scheduler() : heap(), queued(0), served(0) { }
+
+/**
+ * Heap order - makes the std heap functions (max-heaps) keep the lowest rank, then earliest position, on top.
+ */
+bool Scheduler::servedAfter(const Entry &a, const Entry &b) {
+    return a.rank != b.rank ? a.rank > b.rank : a.position > b.position;
+}
+
+/**
+ * @param policy the scheduler to create.
+ * @param soldierSla only used by SchedulerPolicy::Edf.
+ * @param civilianSla only used by SchedulerPolicy::Edf.
+ * @returns a newly allocated scheduler.
+ */
+Scheduler *Scheduler::create(SchedulerPolicy policy, int soldierSla, int civilianSla) {
+    switch (policy) {
+        case SchedulerPolicy::Priority: return new PriorityScheduler();
+        case SchedulerPolicy::Edf: return new EdfScheduler(soldierSla, civilianSla);
+        default: return new FifoScheduler();
+    }
+}
+
+/**
+ * Ranks the orders and builds the heap, replacing whatever was left from the previous step.
+ * @param orders the orders to schedule, in queue order.
+ * @param customers all the customers, indexed by their ids.
+ */
+void Scheduler::schedule(const PendingOrderList &orders, const CustomerTable &customers) {
+    heap.clear();
+    queued = orders.size();
+    served = 0;
+    if (keepsQueueOrder()) return;
+    heap.reserve(orders.size());
+    for (unsigned long i = 0; i < orders.size(); i++) {
+        heap.push_back({rank(*orders[i], customers[orders[i]->getCustomerId()]), i});
+    }
+    std::make_heap(heap.begin(), heap.end(), servedAfter);
+}
+
+/**
+ * @returns true if there are orders left to serve in the current step.
+ */
+bool Scheduler::hasNext() const {
+    return keepsQueueOrder() ? served < queued : !heap.empty();
+}
+
+/**
+ * @returns the position (in the vector given to schedule) of the next order to serve.
+ * @note Call only if hasNext().
+ */
+unsigned long Scheduler::next() {
+    if (keepsQueueOrder()) return served++;
+    std::pop_heap(heap.begin(), heap.end(), servedAfter);
+    unsigned long position = heap.back().position;
+    heap.pop_back();
+    return position;
+}
+
+bool Scheduler::keepsQueueOrder() const {
+    return false;
+}
+
+// ####################################################################################### //
+//                                      FifoScheduler                                      //
+// ####################################################################################### //
+
+FifoScheduler::FifoScheduler() : Scheduler() { }
+
+FifoScheduler *FifoScheduler::clone() const {
+    return new FifoScheduler(*this);
+}
+
+string FifoScheduler::toString() const {
+    return "scheduler fifo";
+}
+
+/**
+ * @returns 0, orders are served in queue order.
+ */
+long FifoScheduler::rank(const Order &, const Customer &) const {
+    return 0;
+}
+
+bool FifoScheduler::keepsQueueOrder() const {
+    return true;
+}
+
+// ####################################################################################### //
+//                                    PriorityScheduler                                    //
+// ####################################################################################### //
+
+PriorityScheduler::PriorityScheduler() : Scheduler() { }
+
+PriorityScheduler *PriorityScheduler::clone() const {
+    return new PriorityScheduler(*this);
+}
+
+string PriorityScheduler::toString() const {
+    return "scheduler priority";
+}
+
+/**
+ * @returns 0 for soldiers' orders, 1 for civilians' orders.
+ */
+long PriorityScheduler::rank(const Order &, const Customer &customer) const {
+    return customer.getType() == CustomerType::Soldier ? 0 : 1;
+}
+
+// ####################################################################################### //
+//                                       EdfScheduler                                      //
+// ####################################################################################### //
+
+/**
+ * @param soldierSla steps a soldier's order may take from placement to completion.
+ * @param civilianSla steps a civilian's order may take from placement to completion.
+ */
+EdfScheduler::EdfScheduler(int soldierSla, int civilianSla) :
+    Scheduler(),
+    soldierSla(soldierSla),
+    civilianSla(civilianSla)
+{ }
+
+EdfScheduler *EdfScheduler::clone() const {
+    return new EdfScheduler(*this);
+}
+
+string EdfScheduler::toString() const {
+    return "scheduler edf " + std::to_string(soldierSla) + " " + std::to_string(civilianSla);
+}
+
+/**
+ * @returns the step the order is due at.
+ */
+long EdfScheduler::rank(const Order &order, const Customer &customer) const {
+    return (long) order.getCreatedStep() + (customer.getType() == CustomerType::Soldier ? soldierSla : civilianSla);
+}
@@ -0,0 +1,92 @@
+#include "../include/ServiceTime.h"
+
+#include <cmath>
+#include <algorithm>
+
+#define PHILOX_M0 0xD2511F53u
+#define PHILOX_M1 0xCD9E8D57u
+#define PHILOX_W0 0x9E3779B9u
+#define PHILOX_W1 0xBB67AE85u
+#define PHILOX_ROUNDS 10
+
+/**
+ * Philox4x32-10 (Salmon et al., "Parallel random numbers: as easy as 1, 2, 3").
+ * @param counter the block to encrypt, replaced by the random output.
+ * @param key the key, the generator's seed.
+ */
+static inline void philox(uint32_t counter[4], uint32_t key0, uint32_t key1) {
+    for (int round = 0; round < PHILOX_ROUNDS; round++) {
+        uint64_t product0 = (uint64_t) PHILOX_M0 * counter[0];
+        uint64_t product1 = (uint64_t) PHILOX_M1 * counter[2];
+        uint32_t next0 = (uint32_t) (product1 >> 32) ^ counter[1] ^ key0;
+        uint32_t next2 = (uint32_t) (product0 >> 32) ^ counter[3] ^ key1;
+        counter[1] = (uint32_t) product1;
+        counter[3] = (uint32_t) product0;
+        counter[0] = next0;
+        counter[2] = next2;
+        key0 += PHILOX_W0;
+        key1 += PHILOX_W1;
+    }
+}
+
+ServiceTime::ServiceTime() : distribution(ServiceDistribution::Fixed), spread(DEFAULT_SERVICE_SPREAD), key{0, 0} { }
+
+/**
+ * @param distribution the distribution of the service times.
+ * @param spread percent the Uniform distribution spreads around the nominal time.
+ */
+ServiceTime::ServiceTime(ServiceDistribution distribution, int spread) :
+    distribution(distribution),
+    spread(std::min(100, std::max(0, spread))),
+    key{0, 0}
+{ }
+
+void ServiceTime::setSeed(unsigned long long seed) {
+    key[0] = (uint32_t) seed;
+    key[1] = (uint32_t) (seed >> 32);
+}
+
+/**
+ * @param nominal the fixed service time.
+ * @param volunteerId the volunteer serving the order.
+ * @param orderId the order being served.
+ * @returns the order's service time, at least 1 unless nominal is 0. Always the same for the same seed, volunteer
+ * and order.
+ */
+int ServiceTime::sample(int nominal, int volunteerId, int orderId) const {
+    if (distribution == ServiceDistribution::Fixed || nominal <= 0) return nominal;
+    uint32_t counter[4] = {(uint32_t) orderId, (uint32_t) volunteerId, 0, 0};
+    philox(counter, key[0], key[1]);
+    double u = (counter[0] + 0.5) * (1.0 / 4294967296.0); // In (0, 1)
+    double factor = distribution == ServiceDistribution::Uniform ? 1 + spread / 100.0 * (2 * u - 1) : -std::log(u);
+    return std::max(1, (int) (nominal * factor + 0.5));
+}
+
+ServiceDistribution ServiceTime::getDistribution() const {
+    return distribution;
+}
+
+int ServiceTime::getSpread() const {
+    return spread;
+}
+
+/**
+ * @param name one of fixed, uniform, exponential.
+ * @param distribution set to the matching distribution.
+ * @returns false if the name is unknown.
+ */
+bool ServiceTime::parseDistribution(const string &name, ServiceDistribution &distribution) {
+    if (name == "fixed") distribution = ServiceDistribution::Fixed;
+    else if (name == "uniform") distribution = ServiceDistribution::Uniform;
+    else if (name == "exponential") distribution = ServiceDistribution::Exponential;
+    else return false;
+    return true;
+}
+
+string ServiceTime::distributionName(ServiceDistribution distribution) {
+    switch (distribution) {
+        case ServiceDistribution::Uniform: return "uniform";
+        case ServiceDistribution::Exponential: return "exponential";
+        default: return "fixed";
+    }
+}
@@ -0,0 +1,94 @@
+#include "../include/SessionRecorder.h"
+#include "../include/CommandCodec.h"
+
+#define RECORDING_MAGIC "WHREC001"
+#define RECORDING_MAGIC_SIZE 8
+
+RecordedCommand::RecordedCommand() : micros(0), payload() { }
+
+/**
+ * LEB128 - 7 bits per byte, the high bit marks that more bytes follow.
+ */
+static void putVarint(string &out, unsigned long value) {
+    while (value >= 0x80) {
+        out += (char) (value | 0x80);
+        value >>= 7;
+    }
+    out += (char) value;
+}
+
+/**
+ * @returns false if the data ended in the middle of the varint.
+ */
+static bool getVarint(const string &data, size_t &offset, unsigned long &value) {
+    value = 0;
+    for (int shift = 0; offset < data.size() && shift < 64; shift += 7) {
+        unsigned char byte = data[offset++];
+        value |= (unsigned long) (byte & 0x7F) << shift;
+        if (!(byte & 0x80)) return true;
+    }
+    return false;
+}
+
+/**
+ * Starts a recording, the session's clock starts now.
+ * @param path the recording file, an existing file is replaced.
+ */
+SessionRecorder::SessionRecorder(const string &path) :
+    out(path, std::ios::binary | std::ios::trunc),
+    start(std::chrono::steady_clock::now()),
+    lastMicros(0),
+    buffer()
+{
+    out.write(RECORDING_MAGIC, RECORDING_MAGIC_SIZE);
+}
+
+/**
+ * @param command a line the session read, recorded with the time it was read at.
+ */
+void SessionRecorder::record(const string &command) {
+    long micros = std::chrono::duration_cast<std::chrono::microseconds>(
+        std::chrono::steady_clock::now() - start).count();
+    string payload;
+    CommandCodec::encode(command, payload);
+    buffer.clear();
+    putVarint(buffer, micros - lastMicros);
+    putVarint(buffer, payload.size());
+    buffer += payload;
+    out.write(buffer.data(), buffer.size()); // Buffered, recording must not slow the session down
+    lastMicros = micros;
+}
+
+/**
+ * @returns true if the recording file could be opened.
+ */
+bool SessionRecorder::isOpen() const {
+    return out.is_open();
+}
+
+/**
+ * Reads a whole recording, a record cut off at the end (the session crashed while writing it) is ignored.
+ * @param path the recording file.
+ * @param commands filled with the recorded commands.
+ * @returns false if the file can't be read or isn't a recording.
+ */
+bool SessionRecorder::load(const string &path, vector<RecordedCommand> &commands) {
+    std::ifstream in(path, std::ios::binary | std::ios::ate);
+    if (!in || in.tellg() < RECORDING_MAGIC_SIZE) return false;
+    string data(in.tellg(), '\0');
+    in.seekg(0);
+    in.read(&data[0], data.size());
+    if (data.compare(0, RECORDING_MAGIC_SIZE, RECORDING_MAGIC) != 0) return false;
+
+    size_t offset = RECORDING_MAGIC_SIZE;
+    long micros = 0;
+    unsigned long delta, size;
+    while (getVarint(data, offset, delta) && getVarint(data, offset, size) && size <= data.size() - offset) {
+        commands.push_back(RecordedCommand());
+        micros += (long) delta;
+        commands.back().micros = micros;
+        commands.back().payload.assign(data, offset, size);
+        offset += size;
+    }
+    return true;
+}
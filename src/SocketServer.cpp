@@ -0,0 +1,333 @@
+#include "../include/SocketServer.h"
+#include "../include/WareHouse.h"
+
+#include <iostream>
+#include <cerrno>
+#include <cstring>
+#include <cstdint>
+#include <fcntl.h>
+#include <unistd.h>
+#include <sys/epoll.h>
+#include <sys/eventfd.h>
+#include <sys/socket.h>
+#include <sys/un.h>
+
+#define MAX_EVENTS 64
+#define READ_CHUNK 65536
+
+/**
+ * @param wareHouse the warehouse the commands are performed on.
+ * @param path the socket's path, an existing socket file is replaced.
+ * @param recorder records every command performed, nullptr if the session isn't recorded. Not owned.
+ */
+SocketServer::SocketServer(WareHouse &wareHouse, const string &path, SessionRecorder *recorder) :
+    wareHouse(wareHouse),
+    path(path),
+    recorder(recorder),
+    listenFd(-1),
+    epollFd(-1),
+    wakeFd(-1),
+    clients(),
+    response(),
+    simulation(),
+    lock(),
+    submitted(),
+    waiting(),
+    performed(),
+    closed(false),
+    stopping(false)
+{ }
+
+static bool setNonBlocking(int fd) {
+    int flags = fcntl(fd, F_GETFL, 0);
+    return flags != -1 && fcntl(fd, F_SETFL, flags | O_NONBLOCK) != -1;
+}
+
+/**
+ * Binds the socket and serves clients until one of them closes the warehouse.
+ * @returns false if the socket couldn't be set up.
+ */
+bool SocketServer::run() {
+    sockaddr_un address;
+    std::memset(&address, 0, sizeof(address));
+    address.sun_family = AF_UNIX;
+    if (path.size() >= sizeof(address.sun_path)) {
+        std::cout << "Socket path is too long: " << path << std::endl;
+        return false;
+    }
+    std::strcpy(address.sun_path, path.c_str());
+    unlink(path.c_str());
+
+    listenFd = socket(AF_UNIX, SOCK_STREAM, 0);
+    epollFd = epoll_create1(0);
+    wakeFd = eventfd(0, EFD_NONBLOCK);
+    if (listenFd == -1 || epollFd == -1 || wakeFd == -1 || !setNonBlocking(listenFd) ||
+        bind(listenFd, (sockaddr *) &address, sizeof(address)) == -1 || listen(listenFd, SOMAXCONN) == -1) {
+        std::cout << "Failed to listen on " << path << ": " << std::strerror(errno) << std::endl;
+        return false;
+    }
+    watch(listenFd, EPOLLIN, EPOLL_CTL_ADD);
+    watch(wakeFd, EPOLLIN, EPOLL_CTL_ADD);
+    std::cout << "Warehouse is open! Listening on " << path << std::endl;
+    simulation = std::thread(&SocketServer::simulate, this);
+
+    vector<epoll_event> events(MAX_EVENTS);
+    bool open = true;
+    while (open) {
+        int ready = epoll_wait(epollFd, events.data(), MAX_EVENTS, -1);
+        if (ready == -1) {
+            if (errno == EINTR) continue;
+            break;
+        }
+        for (int i = 0; i < ready; i++) {
+            int fd = events[i].data.fd;
+            if (fd == listenFd) {
+                acceptClients();
+                continue;
+            }
+            if (fd == wakeFd) {
+                uint64_t count;
+                while (read(wakeFd, &count, sizeof(count)) > 0) { } // Resets the eventfd
+                open = collectPerformed();
+                continue;
+            }
+            map<int, Client>::iterator it = clients.find(fd);
+            if (it == clients.end()) continue;
+            if (events[i].events & EPOLLOUT) {
+                it->second.waitingOutput = false;
+                watch(fd, it->second.hungUp ? 0 : EPOLLIN, EPOLL_CTL_MOD);
+            }
+            if (events[i].events & (EPOLLIN | EPOLLHUP | EPOLLERR)) {
+                readClient(fd, it->second);
+            }
+            if (events[i].events & (EPOLLHUP | EPOLLERR)) {
+                // Reported regardless of the watched events, stop watching while its commands are still performed.
+                epoll_ctl(epollFd, EPOLL_CTL_DEL, fd, nullptr);
+            }
+        }
+        // Responses of the whole batch are written at once, one write per client.
+        vector<int> finished;
+        for (map<int, Client>::iterator it = clients.begin(); it != clients.end(); ++it) {
+            writeClient(it->first, it->second);
+            // A client is only closed once its commands were answered, its descriptor may be reused right away.
+            if (it->second.hungUp && it->second.output.empty() && it->second.performing == 0) {
+                finished.push_back(it->first);
+            }
+        }
+        for (int fd : finished) closeClient(fd);
+    }
+    stopSimulation();
+    // Flush what's left before leaving, the warehouse was closed.
+    for (map<int, Client>::iterator it = clients.begin(); it != clients.end(); ++it) {
+        setNonBlocking(it->first); // Best effort, clients which don't read are dropped
+        writeClient(it->first, it->second);
+    }
+    return true;
+}
+
+/**
+ * The simulation thread: performs the batches in the order they were sent, publishes a read view with their
+ * changes and hands their output back to the event loop. Batches sent after the warehouse was closed are dropped.
+ */
+void SocketServer::simulate() {
+    std::unique_lock<std::mutex> guard(lock);
+    while (true) {
+        submitted.wait(guard, [this]() { return stopping || !waiting.empty(); });
+        if (stopping) return;
+        Batch batch = std::move(waiting.front());
+        waiting.pop_front();
+        guard.unlock();
+
+        std::streambuf *console = std::cout.rdbuf(response.rdbuf());
+        for (const string &command : batch.commands) {
+            if (!wareHouse.isOpened()) break;
+            if (recorder) recorder->record(command);
+            wareHouse.execute(command);
+        }
+        std::cout.rdbuf(console);
+        batch.output = response.str();
+        response.str("");
+        wareHouse.refreshReadView(); // The client's next status queries are answered from the view
+        bool open = wareHouse.isOpened();
+
+        guard.lock();
+        closed = closed || !open;
+        performed.push_back(std::move(batch));
+        uint64_t one = 1;
+        if (write(wakeFd, &one, sizeof(one)) == -1) { } // Can only fail if the counter overflows, it's read first
+    }
+}
+
+/**
+ * Hands the output of the performed batches to their clients.
+ * @returns false once the warehouse was closed.
+ */
+bool SocketServer::collectPerformed() {
+    vector<Batch> batches;
+    bool open;
+    {
+        std::lock_guard<std::mutex> guard(lock);
+        batches.swap(performed);
+        open = !closed;
+    }
+    for (Batch &batch : batches) {
+        map<int, Client>::iterator it = clients.find(batch.fd);
+        if (it == clients.end()) continue;
+        it->second.output += batch.output;
+        it->second.performing--;
+    }
+    return open;
+}
+
+/**
+ * Stops the simulation thread, the batches it didn't start are dropped.
+ */
+void SocketServer::stopSimulation() {
+    if (!simulation.joinable()) return;
+    {
+        std::lock_guard<std::mutex> guard(lock);
+        stopping = true;
+    }
+    submitted.notify_one();
+    simulation.join();
+    collectPerformed();
+}
+
+/**
+ * Accepts every pending connection.
+ */
+void SocketServer::acceptClients() {
+    while (true) {
+        int fd = accept(listenFd, nullptr, nullptr);
+        if (fd == -1) return; // EAGAIN - no more pending connections
+        if (!setNonBlocking(fd)) {
+            close(fd);
+            continue;
+        }
+        clients[fd] = Client();
+        watch(fd, EPOLLIN, EPOLL_CTL_ADD);
+    }
+}
+
+/**
+ * Reads everything available and performs every complete line, in order.
+ */
+void SocketServer::readClient(int fd, Client &client) {
+    char buffer[READ_CHUNK];
+    while (true) {
+        ssize_t count = read(fd, buffer, sizeof(buffer));
+        if (count > 0) {
+            client.input.append(buffer, count);
+        } else {
+            if (count == 0 || (errno != EAGAIN && errno != EWOULDBLOCK)) {
+                client.hungUp = true;
+                watch(fd, client.waitingOutput ? EPOLLOUT : 0, EPOLL_CTL_MOD); // Nothing more to read
+            }
+            break;
+        }
+    }
+    if (client.hungUp && !client.input.empty() && client.input[client.input.size() - 1] != '\n') {
+        client.input += '\n'; // The last command may come without a new line
+    }
+
+    Batch batch(fd);
+    string::size_type start = 0, end;
+    while ((end = client.input.find('\n', start)) != string::npos) {
+        string line = client.input.substr(start, end - start);
+        if (!line.empty() && line[line.size() - 1] == '\r') line.erase(line.size() - 1);
+        start = end + 1;
+        if (client.performing > 0 || !batch.commands.empty() || !answerFromView(line, client.output)) {
+            batch.commands.push_back(line);
+        }
+    }
+    client.input.erase(0, start);
+    if (batch.commands.empty()) return;
+    client.performing++;
+    {
+        std::lock_guard<std::mutex> guard(lock);
+        waiting.push_back(std::move(batch));
+    }
+    submitted.notify_one();
+}
+
+/**
+ * Answers a plain orderStatus, customerStatus or volunteerStatus command from the latest read view.
+ * @param output the command's output is appended to it, as the command would print it.
+ * @returns false if the command isn't one of those or read views aren't published, it's left to the simulation.
+ */
+bool SocketServer::answerFromView(const string &line, string &output) const {
+    vector<string> words = splitIntoWords(line);
+    int id;
+    if (words.size() != 2 || !ActionFactory::parseInt(words[1], id)) return false;
+    if (words[0] != ORDERSTATUS && words[0] != CUSTOMERSTATUS && words[0] != VOLUNTEERSTATUS) return false;
+    shared_ptr<const ReadView> view = wareHouse.getReadView();
+    if (view == nullptr) return false;
+    if (words[0] == ORDERSTATUS) output += view->orderStatus(id);
+    else if (words[0] == CUSTOMERSTATUS) output += view->customerStatus(id);
+    else output += view->volunteerStatus(id);
+    output += '\n';
+    return true;
+}
+
+/**
+ * Writes as much of the pending responses as the socket takes, waits for EPOLLOUT for the rest.
+ */
+void SocketServer::writeClient(int fd, Client &client) {
+    if (client.waitingOutput || client.output.empty()) return;
+    string::size_type written = 0;
+    int error = 0;
+    while (written < client.output.size()) {
+        ssize_t count = send(fd, client.output.data() + written, client.output.size() - written, MSG_NOSIGNAL);
+        if (count <= 0) {
+            error = errno;
+            break;
+        }
+        written += count;
+    }
+    client.output.erase(0, written);
+    if (client.output.empty()) return;
+    if (error == EAGAIN || error == EWOULDBLOCK) {
+        client.waitingOutput = true;
+        watch(fd, client.hungUp ? EPOLLOUT : EPOLLIN | EPOLLOUT, EPOLL_CTL_MOD);
+    } else { // The client is gone
+        client.output.clear();
+        client.hungUp = true;
+    }
+}
+
+/**
+ * Registers (or modifies) the events epoll reports for the descriptor.
+ */
+void SocketServer::watch(int fd, unsigned int events, int operation) {
+    epoll_event event;
+    std::memset(&event, 0, sizeof(event));
+    event.events = events;
+    event.data.fd = fd;
+    epoll_ctl(epollFd, operation, fd, &event);
+}
+
+void SocketServer::closeClient(int fd) {
+    epoll_ctl(epollFd, EPOLL_CTL_DEL, fd, nullptr);
+    close(fd);
+    clients.erase(fd);
+}
+
+/**
+ * Stops the simulation thread, disconnects the clients and removes the socket file.
+ */
+SocketServer::~SocketServer() {
+    stopSimulation();
+    while (!clients.empty()) {
+        closeClient(clients.begin()->first);
+    }
+    if (listenFd != -1) {
+        close(listenFd);
+        unlink(path.c_str());
+    }
+    if (epollFd != -1) {
+        close(epollFd);
+    }
+    if (wakeFd != -1) {
+        close(wakeFd);
+    }
+}
@@ -0,0 +1,54 @@
+#include "../include/StringPool.h"
+
+#include <functional>
+
+StringPool::StringPool() : memory(MemoryContext::create()), strings(), ids() {
+    MemoryScope scope(memory);
+    strings = decltype(strings)(); // An empty deque allocates, charge it to the pool's context
+}
+
+StringPool::~StringPool() {
+    memory->release(); // Deleted once the strings and ids are freed
+}
+
+/**
+ * @param str the string to intern.
+ * @returns the string's id, the same id for equal strings.
+ */
+uint32_t StringPool::intern(const string &str) {
+    MemoryScope scope(memory);
+    size_t hash = std::hash<string>()(str);
+    auto range = ids.equal_range(hash);
+    for (auto it = range.first; it != range.second; ++it) {
+        const Name &interned = strings[it->second];
+        if (interned.size() == str.size() && interned.compare(0, string::npos, str.data(), str.size()) == 0) {
+            return it->second;
+        }
+    }
+    uint32_t id = (uint32_t) strings.size();
+    strings.push_back(Name(str.data(), str.size()));
+    ids.emplace(hash, id);
+    return id;
+}
+
+/**
+ * @param id an id returned by intern().
+ * @returns a copy of the interned string.
+ */
+string StringPool::get(uint32_t id) const {
+    return string(strings[id].data(), strings[id].size());
+}
+
+/**
+ * @returns amount of distinct strings interned.
+ */
+uint32_t StringPool::size() const {
+    return (uint32_t) strings.size();
+}
+
+/**
+ * @returns what the pool's strings and ids take, in MemoryCategory::Names.
+ */
+MemoryUsage StringPool::getMemoryUsage() const {
+    return memory->getUsage();
+}
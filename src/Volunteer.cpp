@@ -4,13 +4,63 @@
 // ###                          AbstractVolunteer                          ###
 // ###########################################################################
 
-Volunteer::Volunteer(int id, const string &name) :
+Volunteer::Volunteer(int id, uint32_t nameId) :
     completedOrderId(NO_ORDER),
     activeOrderId(NO_ORDER),
+    finishedOrderIds(),
+    serviceTime(),
     id(id),
-    name(name)
+    nameId(nameId),
+    owners(1)
 { }
 
+Volunteer::Volunteer(const Volunteer &other) :
+    completedOrderId(other.completedOrderId),
+    activeOrderId(other.activeOrderId),
+    finishedOrderIds(other.finishedOrderIds),
+    serviceTime(other.serviceTime),
+    id(other.id),
+    nameId(other.nameId),
+    owners(1)
+{ }
+
+/**
+ * Charged to the current context, see MemoryScope.
+ */
+void *Volunteer::operator new(size_t size) {
+    return MemoryAccounting::allocate(MemoryCategory::Volunteers, size, 1);
+}
+
+/**
+ * Credits the context the volunteer was charged to, its size is recorded with the allocation.
+ */
+void Volunteer::operator delete(void *memory, size_t) {
+    MemoryAccounting::deallocate(memory, MemoryCategory::Volunteers, 1);
+}
+
+/**
+ * Adds an owner, e.g. a fork of the warehouse holding the volunteer. Owners must not change a shared volunteer.
+ * @returns this volunteer.
+ */
+Volunteer *Volunteer::share() {
+    owners.fetch_add(1, std::memory_order_relaxed);
+    return this;
+}
+
+/**
+ * @returns true if more than one warehouse holds the volunteer, it must then be cloned before changing it.
+ */
+bool Volunteer::isShared() const {
+    return owners.load(std::memory_order_acquire) > 1;
+}
+
+/**
+ * Removes an owner, the volunteer is deleted with its last one.
+ */
+void Volunteer::release(Volunteer *volunteer) {
+    if (volunteer->owners.fetch_sub(1, std::memory_order_acq_rel) == 1) delete volunteer;
+}
+
 /**
  * @returns the volunteer's identifier.
  */
@@ -19,10 +69,10 @@ int Volunteer::getId() const{
 }
 
 /**
- * @returns the volunteer's name.
+ * @returns id of the volunteer's name in the warehouse's StringPool.
  */
-const string &Volunteer::getName() const{
-    return name;
+uint32_t Volunteer::getNameId() const{
+    return nameId;
 }
 
 /**
@@ -39,6 +89,13 @@ int Volunteer::getCompletedOrderId() const{
     return completedOrderId;
 }
 
+/**
+ * @returns the orders the volunteer finished during the last step, in the order they were finished.
+ */
+const VolunteerOrderIds &Volunteer::getFinishedOrderIds() const{
+    return finishedOrderIds;
+}
+
 /**
  * @returns true if the volunteer is busy, otherwise false.
  */
@@ -46,17 +103,49 @@ bool Volunteer::isBusy() const{
     return activeOrderId != NO_ORDER;
 }
 
+/**
+ * A volunteer that handles several orders at once keeps taking orders during the step its work was assigned at.
+ * @returns true if the volunteer is busy but can still take orders, false for single order volunteers.
+ */
+bool Volunteer::isLoading() const{
+    return false;
+}
+
+/**
+ * @returns the distribution of the time the volunteer takes to serve an order.
+ */
+const ServiceTime &Volunteer::getServiceTime() const{
+    return serviceTime;
+}
+
+/**
+ * @param serviceTime the distribution of the time the volunteer takes to serve an order.
+ */
+void Volunteer::setServiceTime(const ServiceTime &serviceTime){
+    this->serviceTime = serviceTime;
+}
+
+/**
+ * @param seed the warehouse's seed, the service times are sampled from it.
+ */
+void Volunteer::setServiceSeed(unsigned long long seed){
+    serviceTime.setSeed(seed);
+}
+
 // ###########################################################################
 // ###                         CollectorVolunteer                          ###
 // ###########################################################################
 
 /**
  * @param id the volunteer's identifier.
- * @param name the volunteer's name.
+ * @param nameId id of the volunteer's name in the warehouse's StringPool.
  * @param coolDown the volunteer's cool down.
+ * @param batchSize the number of orders the volunteer can pick in one cycle.
+ * @param extraCoolDown the time each order beyond the first adds to the cycle.
  */
-CollectorVolunteer::CollectorVolunteer(int id, string name, int coolDown) :
-Volunteer(id, name), coolDown(coolDown), timeLeft(0) { }
+CollectorVolunteer::CollectorVolunteer(int id, uint32_t nameId, int coolDown, int batchSize, int extraCoolDown) :
+Volunteer(id, nameId), coolDown(coolDown), timeLeft(0), batchSize(batchSize), extraCoolDown(extraCoolDown),
+cycleLength(0), batchOrderIds() { }
 
 /**
  * @returns a copy of the volunteer.
@@ -65,10 +154,13 @@ CollectorVolunteer *CollectorVolunteer::clone() const  {
     return new CollectorVolunteer(*this);
 }
 
+// The whole batch is finished together at the end of the cycle.
 void CollectorVolunteer::step()  {
+    finishedOrderIds.clear();
     if(activeOrderId != NO_ORDER) {
         if(timeLeft != 0 && decreaseCoolDown()) {
-            completedOrderId = activeOrderId;
+            finishedOrderIds.swap(batchOrderIds);
+            completedOrderId = finishedOrderIds.back();
             activeOrderId = NO_ORDER;
         }
     }
@@ -88,6 +180,28 @@ int CollectorVolunteer::getTimeLeft() const {
     return timeLeft;
 }
 
+/**
+ * @returns the number of orders the volunteer can pick in one cycle.
+ */
+int CollectorVolunteer::getBatchSize() const {
+    return batchSize;
+}
+
+/**
+ * @returns the time each order beyond the first adds to the cycle.
+ */
+int CollectorVolunteer::getExtraCoolDown() const {
+    return extraCoolDown;
+}
+
+/**
+ * Orders are picked during the step the cycle was assigned at, the cycle starts with the volunteer's next step.
+ * @returns true if the volunteer has a cycle that didn't start yet and can pick more orders.
+ */
+bool CollectorVolunteer::isLoading() const {
+    return activeOrderId != NO_ORDER && timeLeft == cycleLength && (int) batchOrderIds.size() < batchSize;
+}
+
 /**
  * Decrease timeLeft by 1 if it is not 0.
  * @returns true if timeLeft=0 and false otherwise.
@@ -111,19 +225,27 @@ bool CollectorVolunteer::hasOrdersLeft() const {
  * @returns true if the volunteer can take the order, otherwise false.
  */
 bool CollectorVolunteer::canTakeOrder(const Order &order) const {
-    return activeOrderId == -1;
+    return activeOrderId == -1 || isLoading();
 }
 
 /**
- * Accepts an order as the volunteer's active order (if it's able to accept order).
+ * Accepts an order as the volunteer's active order (if it's able to accept order), or adds it to the batch
+ * of the cycle that's being loaded - each extra order makes the cycle extraCoolDown longer.
  * @note Does not assign itself as the order's collector volunteer &
  * does not update the status - must be done by the caller.
  * @param order
  */
 void CollectorVolunteer::acceptOrder(const Order &order) {
     if(canTakeOrder(order)) {
-        timeLeft = coolDown;
-        activeOrderId = order.getId();
+        if(activeOrderId == NO_ORDER) {
+            batchOrderIds.clear();
+            timeLeft = serviceTime.sample(coolDown, getId(), order.getId());
+            activeOrderId = order.getId();
+        } else {
+            timeLeft += serviceTime.sample(extraCoolDown, getId(), order.getId());
+        }
+        cycleLength = timeLeft;
+        batchOrderIds.push_back(order.getId());
     }
 }
 
@@ -157,12 +279,15 @@ void CollectorVolunteer::visit(vector<Volunteer *> &freeCollectors, vector<Volun
 
 /**
  * @param id the volunteer's identifier.
- * @param name the volunteer's name.
+ * @param nameId id of the volunteer's name in the warehouse's StringPool.
  * @param coolDown the volunteer's cool down.
  * @param maxOrders the maximum number of orders the volunteer can take.
+ * @param batchSize the number of orders the volunteer can pick in one cycle.
+ * @param extraCoolDown the time each order beyond the first adds to the cycle.
  */
-LimitedCollectorVolunteer::LimitedCollectorVolunteer(int id, string name, int coolDown ,int maxOrders) :
-CollectorVolunteer(id, name, coolDown), maxOrders(maxOrders), ordersLeft(maxOrders) { }
+LimitedCollectorVolunteer::LimitedCollectorVolunteer(int id, uint32_t nameId, int coolDown ,int maxOrders, int batchSize,
+                                                     int extraCoolDown) :
+CollectorVolunteer(id, nameId, coolDown, batchSize, extraCoolDown), maxOrders(maxOrders), ordersLeft(maxOrders) { }
 
 /**
  * @returns a copy of the volunteer.
@@ -178,11 +303,18 @@ bool LimitedCollectorVolunteer::hasOrdersLeft() const {
     return ordersLeft > 0;
 }
 
+/**
+ * @returns true if the volunteer's cycle didn't start yet and it can still pick more orders.
+ */
+bool LimitedCollectorVolunteer::isLoading() const {
+    return CollectorVolunteer::isLoading() && ordersLeft > 0;
+}
+
 /**
  * @returns true if the volunteer can take the order, otherwise false.
  */
 bool LimitedCollectorVolunteer::canTakeOrder(const Order &order) const {
-    return activeOrderId == -1 && ordersLeft > 0;
+    return (activeOrderId == -1 || isLoading()) && ordersLeft > 0;
 }
 
 /**
@@ -237,12 +369,14 @@ string LimitedCollectorVolunteer::toString() const {
 
 /**
  * @param id the volunteer's identifier.
- * @param name the volunteer's name.
+ * @param nameId id of the volunteer's name in the warehouse's StringPool.
  * @param maxDistance the maximum distance the volunteer can travel.
  * @param distancePerStep the distance the volunteer travels in each step.
+ * @param capacity the number of orders the volunteer can carry in one trip.
  */
-DriverVolunteer::DriverVolunteer(int id, string name, int maxDistance, int distancePerStep) :
-Volunteer(id, name), maxDistance(maxDistance), distancePerStep(distancePerStep), distanceLeft(0) {}
+DriverVolunteer::DriverVolunteer(int id, uint32_t nameId, int maxDistance, int distancePerStep, int capacity) :
+Volunteer(id, nameId), maxDistance(maxDistance), distancePerStep(distancePerStep), distanceLeft(0),
+capacity(capacity), tripLength(0), tripOrderIds(), tripDistances() {}
 
 /**
  * @returns a copy of the volunteer.
@@ -272,6 +406,21 @@ int DriverVolunteer::getDistancePerStep() const{
     return distancePerStep;
 }
 
+/**
+ * @returns the number of orders the volunteer can carry in one trip.
+ */
+int DriverVolunteer::getCapacity() const{
+    return capacity;
+}
+
+/**
+ * Orders are loaded during the step the trip was assigned at, the trip starts with the volunteer's next step.
+ * @returns true if the volunteer has a trip that didn't start yet and can carry more orders.
+ */
+bool DriverVolunteer::isLoading() const{
+    return activeOrderId != NO_ORDER && distanceLeft == tripLength && (int) tripOrderIds.size() < capacity;
+}
+
 /**
  * Decrease distanceLeft by distancePerStep.
  * @returns true if distanceLeft<=0,false otherwise.
@@ -295,29 +444,53 @@ bool DriverVolunteer::hasOrdersLeft() const {
  * @returns Signals whether the volunteer is not busy and the order is within the maxDistance.
  */
 bool DriverVolunteer::canTakeOrder(const Order &order) const {
-    return activeOrderId == NO_ORDER && order.getDistance() <= maxDistance;
+    return (activeOrderId == NO_ORDER || isLoading()) && order.getDistance() <= maxDistance;
 }
 
 /**
- * Assigns the order to this driver.
+ * Assigns the order to this driver, adding it to the trip if the driver is still loading.
+ * The active order is the farthest one of the trip, the trip ends when it's delivered.
  * @note Does not assign itself as the order's driver volunteer &
  * does not update the status - must be done by the caller.
  * @param order The order to be assigned.
  */
 void DriverVolunteer::acceptOrder(const Order &order) {
     if(canTakeOrder(order)) {
-        activeOrderId = order.getId();
-        distanceLeft = order.getDistance();
+        if(activeOrderId == NO_ORDER) {
+            tripOrderIds.clear();
+            tripDistances.clear();
+        }
+        int distance = serviceTime.sample(order.getDistance(), getId(), order.getId()); // The road actually taken
+        tripOrderIds.push_back(order.getId());
+        tripDistances.push_back(distance);
+        if(activeOrderId == NO_ORDER || distance > tripLength) {
+            activeOrderId = order.getId();
+            tripLength = distance;
+            distanceLeft = tripLength;
+        }
     }
 }
 
-// Decrease distanceLeft by distancePerStep
+// Decrease distanceLeft by distancePerStep, the orders on the way are delivered as they are reached.
 void DriverVolunteer::step() {
+    finishedOrderIds.clear();
     if(activeOrderId != NO_ORDER) {
         if(distanceLeft != 0 && decreaseDistanceLeft()) {
             completedOrderId = activeOrderId;
             activeOrderId = NO_ORDER;
         }
+        int travelled = tripLength - distanceLeft;
+        unsigned long kept = 0;
+        for (unsigned long i = 0; i < tripOrderIds.size(); i++) {
+            if(travelled > 0 && tripDistances[i] <= travelled) {
+                finishedOrderIds.push_back(tripOrderIds[i]);
+            } else {
+                tripOrderIds[kept] = tripOrderIds[i];
+                tripDistances[kept++] = tripDistances[i];
+            }
+        }
+        tripOrderIds.resize(kept);
+        tripDistances.resize(kept);
     }
 }
 
@@ -352,13 +525,14 @@ void DriverVolunteer::visit(vector<Volunteer *> &freeCollectors, vector<Voluntee
 
 /**
  * @param id the volunteer's identifier.
- * @param name the volunteer's name.
+ * @param nameId id of the volunteer's name in the warehouse's StringPool.
  * @param maxDistance the maximum distance the volunteer can travel.
  * @param distancePerStep the distance the volunteer travels in each step.
  * @param maxOrders the maximum number of orders the volunteer can take.
+ * @param capacity the number of orders the volunteer can carry in one trip.
  */
-LimitedDriverVolunteer::LimitedDriverVolunteer(int id, const string &name, int maxDistance, int distancePerStep,int maxOrders) :
-DriverVolunteer(id, name, maxDistance, distancePerStep), maxOrders(maxOrders), ordersLeft(maxOrders) {}
+LimitedDriverVolunteer::LimitedDriverVolunteer(int id, uint32_t nameId, int maxDistance, int distancePerStep,int maxOrders, int capacity) :
+DriverVolunteer(id, nameId, maxDistance, distancePerStep, capacity), maxOrders(maxOrders), ordersLeft(maxOrders) {}
 
 /**
  * @returns a copy of this volunteer.
@@ -388,12 +562,19 @@ bool LimitedDriverVolunteer::hasOrdersLeft() const {
     return ordersLeft > 0;
 }
 
+/**
+ * @returns true if the volunteer's trip didn't start yet and it can still carry more orders.
+ */
+bool LimitedDriverVolunteer::isLoading() const {
+    return DriverVolunteer::isLoading() && ordersLeft > 0;
+}
+
 /**
  * Signal if the volunteer is not busy, the order is within the maxDistance.
  * @returns true if the volunteer can take the order, otherwise false.
  */
 bool LimitedDriverVolunteer::canTakeOrder(const Order &order) const {
-    return activeOrderId == NO_ORDER && order.getDistance() <= getMaxDistance() && ordersLeft > 0;
+    return (activeOrderId == NO_ORDER || isLoading()) && order.getDistance() <= getMaxDistance() && ordersLeft > 0;
 }
 
 /**
@@ -1,5 +1,7 @@
 #include "../include/WareHouse.h"
 #include "../include/Action.h"
+#include "../include/CommandCodec.h"
+#include "../include/Scenario.h"
 
 #include <iostream>
 #include <fstream>
@@ -7,22 +9,51 @@
 #include "../include/Volunteer.h"
 
 /**
- * Initializes the warehouse according to the config file. all ids start at 0.
- * @param configFilePath
+ * An empty warehouse that isn't open yet: config-only commands are still accepted. All ids start at 0.
  */
-WareHouse::WareHouse(const string &configFilePath)  :
+WareHouse::WareHouse() :
+    memory(MemoryContext::create()),
     isOpen(false),
     actionsLog(),
     volunteers(),
+    orders(),
     pendingOrders(),
     inProcessOrders(),
     completedOrders(),
+    orderIndex(),
+    history(),
+    tracking(true),
     customers(),
     customerCounter(0),
     volunteerCounter(0),
-    actionFactory(),
-    orderCounter(0)
-{
+    names(std::make_shared<StringPool>()),
+    actionFactory(names),
+    orderCounter(0),
+    stepCount(0),
+    tracer(nullptr),
+    journal(nullptr),
+    stepCommand(nullptr),
+    unjournaledSteps(0),
+    unjournaledOrders(),
+    stepsSplit(false),
+    submittedOrders(),
+    publishingViews(false),
+    readView(),
+    changedOrders(),
+    changedCustomers(),
+    changedVolunteers(),
+    dispatchPolicy(DispatchPolicy::Greedy),
+    seed(0),
+    scheduler(new FifoScheduler()),
+    scenarioRunner(nullptr)
+{ }
+
+/**
+ * Initializes the warehouse according to the config file. all ids start at 0.
+ * @param configFilePath
+ */
+WareHouse::WareHouse(const string &configFilePath) : WareHouse() {
+    MemoryScope scope(memory);
     std::ifstream configFile(configFilePath);
     std::string line;
     if (!configFile.is_open()) {
@@ -56,41 +87,165 @@ WareHouse::WareHouse(const string &configFilePath)  :
 
 /**
  * Starts the warehouse.
+ * @param recorder records every line read, nullptr if the session isn't recorded. Not owned.
  * @note This function is blocking.
  */
-void WareHouse::start() {
+void WareHouse::start(SessionRecorder *recorder) {
     cout << "Warehouse is open!" << endl;
     while(isOpen) {
         string input;
         getline(cin, input);  // Read user input
         //removeCarriageReturn(input); ONLY IN DEBUG
-        try {
-            BaseAction *action = actionFactory.createAction(input, isOpen);
-            if (action) {
-                action->act(*this);
-                // If the action resulted in an error it should have already printed the error.
-                actionsLog.push_back(action);
-            }
-            else {
-                cout << "Unrecognizable action!" << endl;
-            }
+        if (recorder) recorder->record(input);
+        execute(input);
+    }
+    // Cleanup here if needed, I think the Close() action should handle this, not sure though.
+}
+
+/**
+ * Parses and performs a single command, then logs it - exactly what the REPL does with each line.
+ * Logged commands are also appended to the journal, except close: a restored session goes on from before it.
+ * @param input - a command in the actions grammar (e.g. order 2).
+ */
+void WareHouse::execute(const string &input) {
+    MemoryScope scope(memory);
+    try {
+        BaseAction *action = actionFactory.createAction(input, isOpen);
+        if (action) {
+            stepCommand = journal && (CommandCodec::isStep(input) || CommandCodec::isGenerate(input)) ? action : nullptr;
+            unjournaledSteps = 0;
+            unjournaledOrders.clear();
+            stepsSplit = false;
+            performAndJournal(action, input);
         }
-        catch (exception &ex)
-        {
-            std::cout << "Error: " << ex.what() << std::endl;
+        else {
+            cout << "Unrecognizable action!" << endl;
         }
     }
-    // Cleanup here if needed, I think the Close() action should handle this, not sure though.
+    catch (exception &ex)
+    {
+        std::cout << "Error: " << ex.what() << std::endl;
+    }
+    stepCommand = nullptr;
+}
+
+/**
+ * Performs an already parsed action and logs it.
+ * @param action - the action to perform, the warehouse takes ownership of it.
+ */
+void WareHouse::perform(BaseAction *action) {
+    MemoryScope scope(memory);
+    MemoryAccounting::adopt(action, MemoryCategory::Actions, 1, memory);
+    action->act(*this);
+    // If the action resulted in an error it should have already printed the error.
+    actionsLog.append(action);
+}
+
+/**
+ * Performs an already parsed action, appends it to the journal (the action's own encoding of the command, see
+ * BaseAction::encode) and logs it.
+ * @param action - the action to perform, the warehouse takes ownership of it.
+ * @param command - the command the action was created from.
+ */
+void WareHouse::performAndJournal(BaseAction *action, const string &command) {
+    MemoryAccounting::adopt(action, MemoryCategory::Actions, 1, memory);
+    action->act(*this);
+    if (journal && isOpen) {
+        if (action == stepCommand && stepsSplit) {
+            journalSteps(); // The steps after the last drained order
+        } else {
+            string payload;
+            action->encode(command, payload);
+            journal->appendPayload(payload);
+        }
+    }
+    actionsLog.append(action);
+}
+
+/**
+ * Journals what the running step or generate command performed since it started or since the last drained order,
+ * as the step and order commands that replay it.
+ */
+void WareHouse::journalSteps() {
+    for (int entry : unjournaledOrders) {
+        journal->append(entry < 0 ? "step " + to_string(-entry) : "order " + to_string(entry));
+    }
+    unjournaledOrders.clear();
+    if (unjournaledSteps > 0) journal->append("step " + to_string(unjournaledSteps));
+    unjournaledSteps = 0;
 }
 
 /**
  * Adds a the order to the pending orders vector.
- * @note Must be a newly allocated order.
- * @param order - the order to add.
+ * @param order - the order to add, it's copied into the warehouse's order pool.
+ * @returns the warehouse's copy of the order.
  */
-void WareHouse::addOrder(Order* order) {
+Order &WareHouse::addOrder(const Order &placed) {
+    MemoryScope scope(memory);
+    Order *order = &orders.add(placed);
+    order->setCreatedStep(stepCount);
     pendingOrders.push_back(order);
+    if (tracking) {
+        orderIndex.add(*order);
+        history.record(order->getId(), stepCount, OrderStatus::PENDING, NO_VOLUNTEER);
+    }
     orderCounter += 1;
+    if (tracer) tracer->record(stepCount, order->getId(), TracePhase::Pending, NO_VOLUNTEER);
+    if (publishingViews) {
+        changedOrders.push_back(order);
+        changedCustomers.push_back(order->getCustomerId());
+    }
+    return *order;
+}
+
+/**
+ * Places orders in bulk, for each of the customers in turn count orders are placed as if by AddOrder.
+ * A customer that doesn't exist or reached its max orders has the rest of its orders rejected.
+ * @param customerIds the customers placing the orders.
+ * @param count amount of orders placed by each of the customers.
+ * @returns amount of orders placed.
+ */
+int WareHouse::addOrders(const vector<int> &customerIds, int count) {
+    MemoryScope scope(memory);
+    unsigned long requested = customerIds.size() * (unsigned long) count;
+    if (customerIds.size() == 1 && customerIds[0] >= 0 && customerIds[0] < customers.size()) {
+        const Customer &customer = customers[customerIds[0]];
+        requested = std::min(requested, (unsigned long) (customer.getMaxOrders() - customer.getNumOrders()));
+    }
+    pendingOrders.reserve(pendingOrders.size() + requested);
+    int placed = 0;
+    for (int customerId : customerIds) {
+        for (int i = 0; i < count && placeOrder(customerId); i++) {
+            placed++;
+        }
+    }
+    return placed;
+}
+
+/**
+ * Places a single order for the customer, as AddOrder does without the action.
+ * @returns false if the customer doesn't exist or reached its max orders.
+ */
+bool WareHouse::placeOrder(int customerId) {
+    MemoryScope scope(memory);
+    if (!customers.addOrder(customerId, orderCounter)) return false;
+    addOrder(Order(orderCounter, customerId, customers[customerId].getCustomerDistance()));
+    return true;
+}
+
+/**
+ * Places an order for the running generate command. While journaling the order is remembered, so if orders drained
+ * during the generate's steps split it, the journal replays the order at its step (see drainSubmittedOrders).
+ * @returns false if the customer doesn't exist or reached its max orders.
+ */
+bool WareHouse::placeGeneratedOrder(int customerId) {
+    if (!placeOrder(customerId)) return false;
+    if (stepCommand) {
+        if (unjournaledSteps > 0) unjournaledOrders.push_back(-unjournaledSteps);
+        unjournaledSteps = 0;
+        unjournaledOrders.push_back(customerId);
+    }
+    return true;
 }
 
 /**
@@ -99,7 +254,9 @@ void WareHouse::addOrder(Order* order) {
  */
 void WareHouse::addAction(BaseAction* action) {
     //Only call this function once per action;
-    actionsLog.push_back(action);
+    MemoryScope scope(memory);
+    MemoryAccounting::adopt(action, MemoryCategory::Actions, 1, memory);
+    actionsLog.append(action);
 }
 
 /**
@@ -108,8 +265,12 @@ void WareHouse::addAction(BaseAction* action) {
  * @return the id of the volunteer added
  */
 int WareHouse::addVolunteer(Volunteer* volunteer) {
+    MemoryScope scope(memory);
+    MemoryAccounting::adopt(volunteer, MemoryCategory::Volunteers, 1, memory); // May have been made outside of the scope
+    volunteer->setServiceSeed(seed);
     volunteers.push_back(volunteer);
     volunteerCounter += 1;
+    if (publishingViews) changedVolunteers.push_back(volunteer->getId());
     return volunteer->getId();
 }
 
@@ -122,84 +283,136 @@ int WareHouse::addVolunteer(Volunteer* volunteer) {
  * @returns A unique identifier of the customer for future querying.
  */
 int WareHouse::addCustomer(int type, const string &name, int locationDistance, int maxOrders) {
-    Customer *customer = nullptr;
-    // Consider using a map/switch instead of if-else, right now it's ok.
-    if(type == 0) {
-        customer = new SoldierCustomer(customerCounter, name, locationDistance, maxOrders);
-    } else if (type == 1) {
-        customer = new CivilianCustomer(customerCounter, name, locationDistance, maxOrders);
-    } else {
-        return -1;
-    }
-    customers.push_back(customer);
+    return addCustomer(type, names->intern(name), locationDistance, maxOrders);
+}
+
+/**
+ * Adds a new Customer instance into the system.
+ * @param type Casted from enum {@link CustomerType} at {@link Action.h}.
+ * @param nameId Id of the customer's name in getNames().
+ * @param locationDistance Costumer's distance from the warehouse.
+ * @param maxOrders The maximum number of orders the customer can make.
+ * @returns A unique identifier of the customer for future querying.
+ */
+int WareHouse::addCustomer(int type, uint32_t nameId, int locationDistance, int maxOrders) {
+    if (type != 0 && type != 1) return -1;
+    MemoryScope scope(memory);
+    int id = customers.add(nameId, type == 0 ? CustomerType::Soldier : CustomerType::Civilian, locationDistance,
+                           maxOrders);
     customerCounter++;
-    return customerCounter - 1;
+    if (publishingViews) changedCustomers.push_back(id);
+    return id;
+}
+
+/**
+ * @returns the pool the names of the customers and volunteers are interned in.
+ */
+const shared_ptr<StringPool> &WareHouse::getNames() const {
+    return names;
+}
+
+/**
+ * Makes room for count more customers, used before adding customers in bulk.
+ */
+void WareHouse::reserveCustomers(unsigned long count) {
+    MemoryScope scope(memory);
+    customers.reserve(count);
 }
 
 /**
  * Returns the customer with the given id.
  * @param customerId
  * @return
- * @throws invalid_argument if customer doesn't exist.
- * @note to self: If you're displaying this project in resume - use std::optional, it's not supported in C++11.
- */
-Customer &WareHouse::getCustomer(int customerId) const {
-    if(customerId < customerCounter) {
-        for (Customer *customer: customers) {
-            if (customer->getId() == customerId) {
-                return *customer;
-            }
-        }
+ * @throws invalid_argument if customer doesn't exist, see findCustomer for a lookup that doesn't throw.
+ */
+const Customer &WareHouse::getCustomer(int customerId) const {
+    const Customer *customer = findCustomer(customerId);
+    if (customer == nullptr) {
+        throw invalid_argument("Customer doesn't exist");
     }
-    throw invalid_argument("Customer doesn't exist");
+    return *customer;
 }
 
 /**
  * Returns the volunteer with the given id.
  * @param volunteerId the identifier of the volunteer.
  * @return A reference to the volunteer if exists.
- * @throws invalid_argument if volunteer doesn't exist.
+ * @throws invalid_argument if volunteer doesn't exist, see findVolunteer for a lookup that doesn't throw.
  */
 Volunteer &WareHouse::getVolunteer(int volunteerId) const {
-    if(volunteerId < volunteerCounter) {
-        for (Volunteer *volunteer: volunteers) {
-            if (volunteer->getId() == volunteerId) {
-                return *volunteer;
-            }
-        }
+    Volunteer *volunteer = findVolunteer(volunteerId);
+    if (volunteer == nullptr) {
+        throw invalid_argument("Volunteer doesn't exist");
     }
-    throw invalid_argument("Volunteer doesn't exist");
+    return *volunteer;
 }
 
 /**
  * Returns the order with the given id.
  * @param orderId the identifier of the volunteer.
  * @return A reference to the order if exists.
- * @throws invalid_argument if order doesn't exist.
+ * @throws invalid_argument if order doesn't exist, see findOrder for a lookup that doesn't throw.
  */
 Order &WareHouse::getOrder(int orderId) const {
-    for(Order *o : pendingOrders) {
-        if(o->getId() == orderId) {
-            return *o;
-        }
-    }
-    for(Order *o : inProcessOrders) {
-        if(o->getId() == orderId) {
-            return *o;
-        }
+    Order *order = findOrder(orderId);
+    if (order == nullptr) {
+        throw invalid_argument("Order doesn't exist");
     }
-    for(Order *o : completedOrders) {
-        if(o->getId() == orderId) {
-            return *o;
-        }
-    }
-    throw invalid_argument("Order doesn't exist");
+    return *order;
 }
 
 /**
- * @return A reference to the pending orders vector.
+ * @returns the customer with the given id, nullptr if it doesn't exist. O(1), customer ids are their indices.
  */
-const vector<BaseAction*> &WareHouse::getActions() const {
+const Customer *WareHouse::findCustomer(int customerId) const {
+    return customers.find(customerId);
+}
+
+/**
+ * @param customerId an existing customer.
+ * @returns the ids of the customer's orders, oldest first. Valid until the next order is placed.
+ */
+OrderIdRange WareHouse::getCustomerOrderIds(int customerId) const {
+    return customers.getOrdersIds(customerId);
+}
+
+/**
+ * @returns the volunteer with the given id, nullptr if it doesn't exist (or already finished all its orders).
+ * O(log n), volunteers are kept in the order they were added, which is ascending by id.
+ */
+Volunteer *WareHouse::findVolunteer(int volunteerId) const {
+    VolunteerList::const_iterator found = std::lower_bound(volunteers.begin(), volunteers.end(), volunteerId,
+        [](const Volunteer *volunteer, int id) { return volunteer->getId() < id; });
+    return found != volunteers.end() && (*found)->getId() == volunteerId ? *found : nullptr;
+}
+
+/**
+ * Makes the volunteer this warehouse's own before changing it: a volunteer still shared with a fork (or with the
+ * warehouse this one was forked from) is replaced by a clone, see Volunteer::share.
+ * @param volunteer one of the warehouse's volunteers.
+ * @returns the volunteer to change, the given one if it wasn't shared.
+ */
+Volunteer *WareHouse::ownVolunteer(Volunteer *volunteer) {
+    if (!volunteer->isShared()) return volunteer;
+    Volunteer *own = volunteer->clone();
+    VolunteerList::iterator found = std::lower_bound(volunteers.begin(), volunteers.end(), volunteer->getId(),
+        [](const Volunteer *listed, int id) { return listed->getId() < id; });
+    *found = own;
+    Volunteer::release(volunteer);
+    return own;
+}
+
+/**
+ * @returns the order with the given id, nullptr if it doesn't exist. O(1).
+ */
+Order *WareHouse::findOrder(int orderId) const {
+    return orders.find(orderId);
+}
+
+/**
+ * @return A reference to the log of the performed actions.
+ */
+const ActionLog &WareHouse::getActions() const {
     return actionsLog;
 }
 
@@ -211,6 +424,13 @@ void WareHouse::open() {
     isOpen = true;
 }
 
+/**
+ * @returns true until the warehouse is closed.
+ */
+bool WareHouse::isOpened() const {
+    return isOpen;
+}
+
 /**
  * Destructor of WareHouse.
  * ifs just to be safe
@@ -218,34 +438,12 @@ void WareHouse::open() {
 WareHouse::~WareHouse() {
     for(Volunteer * volunteer : volunteers) {
         if(volunteer) {
-            delete volunteer;
-        }
-    }
-    for (Customer * customer : customers) {
-        if(customer) {
-            delete customer;
-        }
-    }
-    for (Order * order : pendingOrders) {
-        if(order) {
-            delete order;
-        }
-    }
-    for (Order * order : inProcessOrders) {
-        if(order) {
-            delete order;
-        }
-    }
-    for(Order * order : completedOrders) {
-        if(order) {
-            delete order;
-        }
-    }
-    for (BaseAction * action : actionsLog) {
-        if(action) {
-            delete action;
+            Volunteer::release(volunteer); // Forks may still share it
         }
     }
+    delete scheduler;
+    delete scenarioRunner;
+    memory->release(); // Deleted once the members' allocations are freed
 }
 
 /**
@@ -253,102 +451,214 @@ WareHouse::~WareHouse() {
  * @param other - the WareHouse to copy.
  */
 WareHouse::WareHouse(const WareHouse &other) :
+    memory(MemoryContext::create()),
     isOpen(other.isOpen),
-    actionsLog(),
+    actionsLog(), // The containers are copied in the body, within the copy's memory scope
     volunteers(),
+    orders(),
     pendingOrders(),
     inProcessOrders(),
     completedOrders(),
+    orderIndex(),
+    history(),
+    tracking(other.tracking),
     customers(),
     customerCounter(other.customerCounter),
     volunteerCounter(other.volunteerCounter),
-    actionFactory(),
-    orderCounter(other.orderCounter)
+    names(other.names), // Names are only ever added, the pool is shared instead of copied
+    actionFactory(names),
+    orderCounter(other.orderCounter),
+    stepCount(other.stepCount),
+    tracer(nullptr), // Backups are never traced
+    journal(nullptr), // Nor journaled
+    stepCommand(nullptr),
+    unjournaledSteps(0),
+    unjournaledOrders(),
+    stepsSplit(false),
+    submittedOrders(), // Nor fed by other threads
+    publishingViews(false), // Nor publish views
+    readView(),
+    changedOrders(),
+    changedCustomers(),
+    changedVolunteers(),
+    dispatchPolicy(other.dispatchPolicy),
+    seed(other.seed),
+    scheduler(other.scheduler->clone()),
+    scenarioRunner(nullptr) // Copies make their own when they need one
 {
+    MemoryScope scope(memory);
+    // Copied then moved in, so none of the members' storage allocated before the scope is kept
+    actionsLog = ActionLog(other.actionsLog);
+    orders = OrderPool(other.orders);
+    orderIndex = OrderIndex(other.orderIndex);
+    history = OrderHistory(other.history);
+    customers = CustomerTable(other.customers);
     unsigned long size = other.volunteers.size(); // Minimizing calls to size()
-    volunteers = vector<Volunteer*>(size);
+    volunteers = VolunteerList(size);
     for (unsigned long i = 0; i < size; i++) {
         volunteers[i] = other.volunteers[i]->clone();
     }
-    size = other.customers.size();
-    customers = vector<Customer*>(size);
-    for (unsigned long i = 0; i < size; i++) {
-        customers[i] = other.customers[i]->clone();
-    }
     size = other.pendingOrders.size();
-    pendingOrders = vector<Order*>(size);
+    pendingOrders = PendingOrderList(size);
     for (unsigned long i = 0; i < size; i++) {
-        pendingOrders[i] = new Order(*other.pendingOrders[i]);
+        pendingOrders[i] = orders.find(other.pendingOrders[i]->getId());
     }
     size = other.inProcessOrders.size();
-    inProcessOrders = vector<Order*>(size);
+    inProcessOrders = InProcessOrderList(size);
     for (unsigned long i = 0; i < size; i++) {
-        inProcessOrders[i] = new Order(*other.inProcessOrders[i]);
+        inProcessOrders[i] = orders.find(other.inProcessOrders[i]->getId());
     }
     size = other.completedOrders.size();
-    completedOrders = vector<Order*>(size);
+    completedOrders = CompletedOrderList(size);
     for (unsigned long i = 0; i < size; i++) {
-        completedOrders[i] = new Order(*other.completedOrders[i]);
+        completedOrders[i] = orders.find(other.completedOrders[i]->getId());
     }
-    size = other.actionsLog.size();
-    actionsLog = vector<BaseAction*>(size);
-    for (unsigned long i = 0; i < size; i++) {
-        actionsLog[i] = other.actionsLog[i]->clone();
+}
+
+/**
+ * Forking constructor, a copy that can go on stepping but doesn't keep what only looks back: the actions log,
+ * the order indexes and history and the completed orders. The volunteers are shared until either warehouse
+ * changes them (see ownVolunteer), and so are the chunks of the order pool that hold completed orders only.
+ * @param liveOrderIds the orders still pending or in process.
+ */
+WareHouse::WareHouse(const WareHouse &other, const vector<int> &liveOrderIds) :
+    memory(MemoryContext::create()),
+    isOpen(other.isOpen),
+    actionsLog(),
+    volunteers(),
+    orders(),
+    pendingOrders(),
+    inProcessOrders(),
+    completedOrders(),
+    orderIndex(),
+    history(),
+    tracking(false),
+    customers(),
+    customerCounter(other.customerCounter),
+    volunteerCounter(other.volunteerCounter),
+    names(other.names),
+    actionFactory(names),
+    orderCounter(other.orderCounter),
+    stepCount(other.stepCount),
+    tracer(nullptr),
+    journal(nullptr),
+    stepCommand(nullptr),
+    unjournaledSteps(0),
+    unjournaledOrders(),
+    stepsSplit(false),
+    submittedOrders(),
+    publishingViews(false),
+    readView(),
+    changedOrders(),
+    changedCustomers(),
+    changedVolunteers(),
+    dispatchPolicy(other.dispatchPolicy),
+    seed(other.seed),
+    scheduler(other.scheduler->clone()),
+    scenarioRunner(nullptr)
+{
+    MemoryScope scope(memory);
+    orders = OrderPool(other.orders, liveOrderIds);
+    customers = CustomerTable(other.customers);
+    volunteers.reserve(other.volunteers.size());
+    for (Volunteer *volunteer : other.volunteers) {
+        volunteers.push_back(volunteer->share());
+    }
+    pendingOrders.reserve(other.pendingOrders.size());
+    for (const Order *order : other.pendingOrders) {
+        pendingOrders.push_back(orders.find(order->getId()));
+    }
+    inProcessOrders.reserve(other.inProcessOrders.size());
+    for (const Order *order : other.inProcessOrders) {
+        inProcessOrders.push_back(orders.find(order->getId()));
     }
 }
 
+/**
+ * Forks the warehouse for a what-if scenario - the fork steps exactly like the warehouse would, without
+ * copying its history: the actions log, order indexes and history and the completed orders are left out, only
+ * the orders still pending or in process are copied and the volunteers are shared until they change. Queries of
+ * the past don't work on the fork.
+ * Only reads the warehouse, several forks may be made at once from different threads.
+ * @returns the fork, its completed orders are only the ones completed after forking.
+ */
+WareHouse WareHouse::fork() const {
+    vector<int> liveOrderIds;
+    liveOrderIds.reserve(pendingOrders.size() + inProcessOrders.size());
+    for (const Order *order : pendingOrders) liveOrderIds.push_back(order->getId());
+    for (const Order *order : inProcessOrders) liveOrderIds.push_back(order->getId());
+    return WareHouse(*this, liveOrderIds);
+}
+
 /*** Move constructor of WareHouse.
  * @param other - the WareHouse to move.
  */
 WareHouse::WareHouse(WareHouse &&other) noexcept :
+    memory(other.memory), // The moved containers stay charged to it
     isOpen(other.isOpen),
-    actionsLog(),
+    actionsLog(std::move(other.actionsLog)),
     volunteers(),
+    orders(std::move(other.orders)), // Chunks move as they are, the orders keep their addresses
     pendingOrders(),
     inProcessOrders(),
     completedOrders(),
-    customers(),
+    orderIndex(std::move(other.orderIndex)),
+    history(std::move(other.history)),
+    tracking(other.tracking),
+    customers(std::move(other.customers)),
     customerCounter(other.customerCounter),
     volunteerCounter(other.volunteerCounter),
-    actionFactory(),
-    orderCounter(other.orderCounter)
+    names(other.names), // Names are only ever added, the pool is shared instead of copied
+    actionFactory(names),
+    orderCounter(other.orderCounter),
+    stepCount(other.stepCount),
+    tracer(other.tracer),
+    journal(other.journal),
+    stepCommand(nullptr),
+    unjournaledSteps(0),
+    unjournaledOrders(),
+    stepsSplit(false),
+    submittedOrders(), // Requests still queued in other stay there
+    publishingViews(other.publishingViews),
+    readView(std::atomic_load(&other.readView)),
+    changedOrders(std::move(other.changedOrders)),
+    changedCustomers(std::move(other.changedCustomers)),
+    changedVolunteers(std::move(other.changedVolunteers)),
+    dispatchPolicy(other.dispatchPolicy),
+    seed(other.seed),
+    scheduler(other.scheduler),
+    scenarioRunner(other.scenarioRunner)
 {
+    other.scheduler = nullptr;
+    other.scenarioRunner = nullptr;
+    other.tracer = nullptr;
+    other.journal = nullptr;
+    other.memory = MemoryContext::create();
+    MemoryScope scope(memory);
     int size = other.volunteers.size(); // Minimizing calls to size()
-    volunteers = vector<Volunteer*>(size);
+    volunteers = VolunteerList(size);
     for (int i = 0; i < size; i++) {
         volunteers[i] = other.volunteers[i];
         other.volunteers[i] = nullptr;
     }
-    size = other.customers.size();
-    customers = vector<Customer*>(size);
-    for (int i = 0; i < size; i++) {
-        customers[i] = other.customers[i];
-        other.customers[i] = nullptr;
-    }
     size = other.pendingOrders.size();
-    pendingOrders = vector<Order*>(size);
+    pendingOrders = PendingOrderList(size);
     for (int i = 0; i < size; i++) {
         pendingOrders[i] = other.pendingOrders[i];
         other.pendingOrders[i] = nullptr;
     }
     size = other.inProcessOrders.size();
-    inProcessOrders = vector<Order*>(size);
+    inProcessOrders = InProcessOrderList(size);
     for (int i = 0; i < size; i++) {
         inProcessOrders[i] = other.inProcessOrders[i];
         other.inProcessOrders[i] = nullptr;
     }
     size = other.completedOrders.size();
-    completedOrders = vector<Order*>(size);
+    completedOrders = CompletedOrderList(size);
     for (int i = 0; i < size; i++) {
         completedOrders[i] = other.completedOrders[i];
         other.completedOrders[i] = nullptr;
     }
-    size = other.actionsLog.size();
-    actionsLog = vector<BaseAction*>(size);
-    for (int i = 0; i < size; i++) {
-        actionsLog[i] = other.actionsLog[i];
-        other.actionsLog[i] = nullptr;
-    }
 
     other.volunteers.clear();
     other.customers.clear();
@@ -360,31 +670,40 @@ WareHouse::WareHouse(WareHouse &&other) noexcept :
 
 WareHouse& WareHouse::operator=(const WareHouse &other) {
     if(this == &other) return *this; // Self assignment
+    MemoryScope scope(memory);
 
     freeResources();
 
     isOpen = other.isOpen;
     customerCounter = other.customerCounter;
     volunteerCounter = other.volunteerCounter;
+    names = other.names;
+    actionFactory = ActionFactory(names);
+    stepCount = other.stepCount;
+    dispatchPolicy = other.dispatchPolicy;
+    seed = other.seed;
+    delete scheduler;
+    scheduler = other.scheduler->clone();
 
     for (const Volunteer * v: other.volunteers) {
         volunteers.push_back(v->clone());
     }
-    for (const Customer * c: other.customers) {
-        customers.push_back(c->clone());
-    }
+    customers = other.customers;
+    orders = other.orders;
+    orderIndex = other.orderIndex;
+    history = other.history;
+    tracking = other.tracking;
     for (const Order * o: other.pendingOrders) {
-        pendingOrders.push_back(new Order(*o));
+        pendingOrders.push_back(orders.find(o->getId()));
     }
     for (const Order * o: other.inProcessOrders) {
-        inProcessOrders.push_back(new Order(*o));
+        inProcessOrders.push_back(orders.find(o->getId()));
     }
     for (const Order * o: other.completedOrders) {
-        completedOrders.push_back(new Order(*o));
-    }
-    for(const BaseAction * a : other.actionsLog) {
-        actionsLog.push_back(a->clone());
+        completedOrders.push_back(orders.find(o->getId()));
     }
+    actionsLog = other.actionsLog;
+    if (publishingViews) publishReadView(true); // Everything changed
     return *this;
 }
 
@@ -392,46 +711,53 @@ WareHouse& WareHouse::operator=(WareHouse &&other) noexcept {
     if(this == &other) return *this; // Self assignment
 
     freeResources();
+    std::swap(memory, other.memory); // The moved containers stay charged to other's context
+    MemoryScope scope(memory);
     isOpen = other.isOpen;
     customerCounter = other.customerCounter;
     volunteerCounter = other.volunteerCounter;
+    names = other.names;
+    actionFactory = ActionFactory(names);
+    stepCount = other.stepCount;
+    dispatchPolicy = other.dispatchPolicy;
+    seed = other.seed;
+    std::swap(scheduler, other.scheduler);
+    std::swap(scenarioRunner, other.scenarioRunner);
+    tracer = other.tracer;
+    other.tracer = nullptr;
+    journal = other.journal;
+    other.journal = nullptr;
+    orders = std::move(other.orders);
+    orderIndex = std::move(other.orderIndex);
+    history = std::move(other.history);
+    tracking = other.tracking;
+    customers = std::move(other.customers);
 
     int size = other.volunteers.size(); // Minimizing calls to size()
-    volunteers = vector<Volunteer*>(size);
+    volunteers = VolunteerList(size);
     for (int i = 0; i < size; i++) {
         volunteers[i] = other.volunteers[i];
         other.volunteers[i] = nullptr;
     }
-    size = other.customers.size();
-    customers = vector<Customer*>(size);
-    for (int i = 0; i < size; i++) {
-        customers[i] = other.customers[i];
-        other.customers[i] = nullptr;
-    }
     size = other.pendingOrders.size();
-    pendingOrders = vector<Order*>(size);
+    pendingOrders = PendingOrderList(size);
     for (int i = 0; i < size; i++) {
         pendingOrders[i] = other.pendingOrders[i];
         other.pendingOrders[i] = nullptr;
     }
     size = other.inProcessOrders.size();
-    inProcessOrders = vector<Order*>(size);
+    inProcessOrders = InProcessOrderList(size);
     for (int i = 0; i < size; i++) {
         inProcessOrders[i] = other.inProcessOrders[i];
         other.inProcessOrders[i] = nullptr;
     }
     size = other.completedOrders.size();
-    completedOrders = vector<Order*>(size);
+    completedOrders = CompletedOrderList(size);
     for (int i = 0; i < size; i++) {
         completedOrders[i] = other.completedOrders[i];
         other.completedOrders[i] = nullptr;
     }
-    size = other.actionsLog.size();
-    actionsLog = vector<BaseAction*>(size);
-    for (int i = 0; i < size; i++) {
-        actionsLog[i] = actionsLog[i];
-        other.actionsLog[i] = nullptr;
-    }
+    actionsLog = std::move(other.actionsLog);
 
     other.volunteers.clear();
     other.customers.clear();
@@ -440,6 +766,7 @@ WareHouse& WareHouse::operator=(WareHouse &&other) noexcept {
     other.completedOrders.clear();
     other.actionsLog.clear();
 
+    if (publishingViews) publishReadView(true); // Everything changed
     return *this;
 }
 
@@ -449,21 +776,63 @@ WareHouse& WareHouse::operator=(WareHouse &&other) noexcept {
  */
 void WareHouse::freeResources() {
     //[!] Notice - this is a delete operation in an if statement which is in a for loop.
-    for(Volunteer * v : volunteers) if(v) delete v;
-    for(Customer * c : customers) if(c) delete c;
-    for(Order * o : pendingOrders) if(o) delete o;
-    for(Order * o : inProcessOrders) if(o) delete o;
-    for(Order * o : completedOrders) if(o) delete o;
-    for(BaseAction * a : actionsLog) if(a) delete a;
+    for(Volunteer * v : volunteers) if(v) Volunteer::release(v);
 
     volunteers.clear();
     customers.clear();
+    orders.clear();
     pendingOrders.clear();
     inProcessOrders.clear();
     completedOrders.clear();
+    orderIndex.clear();
+    history.clear();
     actionsLog.clear();
 }
 
+/**
+ * Finds the orders matching the query using the warehouse's order indexes.
+ * @param matched set to amount of matching orders, regardless of the query's limit.
+ * @returns the ids of the matching orders, ascending.
+ */
+vector<int> WareHouse::queryOrders(const OrderQuery &query, int &matched) const {
+    return orderIndex.query(query, orders, matched);
+}
+
+/**
+ * Selects how many of the performed actions the log keeps, see ActionLog::setRetention.
+ * @returns false if the spill file couldn't be opened.
+ */
+bool WareHouse::setLogRetention(LogRetention retention, unsigned long limit, const string &spillPath) {
+    MemoryScope scope(memory);
+    return actionsLog.setRetention(retention, limit, spillPath);
+}
+
+/**
+ * Looks up an order as it was after the given amount of steps, from the order history.
+ * @param past set to the order as it was, if it existed by then.
+ * @returns false if there's no such order or it was placed after the step.
+ */
+bool WareHouse::getOrderAt(int orderId, int step, Order &past) const {
+    const Order *order = orders.find(orderId);
+    return order && history.stateAt(*order, step, past);
+}
+
+/**
+ * @returns amount of bytes reserved for storing the orders (the pool and the pointers in the orders' vectors).
+ */
+unsigned long WareHouse::getOrdersMemoryUsage() const {
+    return orders.memoryUsage() + (pendingOrders.capacity() + inProcessOrders.capacity() +
+                                   completedOrders.capacity()) * sizeof(Order*);
+}
+
+/**
+ * @returns what the warehouse's own context holds: its containers, volunteers and logged actions. The shared
+ * names aren't included, see StringPool::getMemoryUsage.
+ */
+MemoryUsage WareHouse::getMemoryUsage() const {
+    return memory->getUsage();
+}
+
 /**
  * @return amount of customers made, for id purposes.
  */
@@ -488,21 +857,21 @@ int WareHouse::getOrderCount() const {
 /**
  * @return pendingOrders vector
  */
-const vector<Order*>& WareHouse::getPendingOrders() const {
+const PendingOrderList& WareHouse::getPendingOrders() const {
     return pendingOrders;
 }
 
 /**
  * @return inProcessOrders vector
  */
-const vector<Order*>& WareHouse::getInProcessOrders() const {
+const InProcessOrderList& WareHouse::getInProcessOrders() const {
     return inProcessOrders;
 }
 
 /**
  * @return completedOrders vector
  */
-const vector<Order*>& WareHouse::getCompletedOrders() const {
+const CompletedOrderList& WareHouse::getCompletedOrders() const {
     return completedOrders;
 }
 
@@ -510,6 +879,9 @@ const vector<Order*>& WareHouse::getCompletedOrders() const {
  * Performs a single step only tto call from SimulateStep::act();
  */
 void WareHouse::step() {
+    MemoryScope scope(memory);
+    drainSubmittedOrders();
+
     vector<Volunteer*> freeCollectors;
     vector<Volunteer*> freeDrivers;
 
@@ -518,25 +890,27 @@ void WareHouse::step() {
         volunteer->visit(freeCollectors, freeDrivers);
     }
 
-    for(unsigned long i = 0; i < pendingOrders.size(); i++) {
-        Order *order = pendingOrders[i];
+    // The scheduler picks which order is served next, assigned orders leave pendingOrders after the loop.
+    scheduler->schedule(pendingOrders, customers);
+    vector<bool> served(pendingOrders.size(), false);
+    // With DispatchPolicy::Matching drivers are assigned to all awaiting orders at once, after this loop.
+    bool greedyDrivers = dispatchPolicy == DispatchPolicy::Greedy;
+    while (scheduler->hasNext() && (!freeCollectors.empty() || (greedyDrivers && !freeDrivers.empty()))) {
+        unsigned long position = scheduler->next();
+        Order *order = pendingOrders[position];
         OrderStatus orderStatus = order->getStatus();
         if(orderStatus == OrderStatus::PENDING) {
             if (!freeCollectors.empty()) {
-                Volunteer *volunteer = freeCollectors.back();
-                freeCollectors.pop_back();
-
-                order->setCollectorId(volunteer->getId());
-                volunteer->acceptOrder(*order);
-                order->setStatus(OrderStatus::COLLECTING);
-                inProcessOrders.push_back(order);
-
-                pendingOrders.erase(find(pendingOrders.begin(), pendingOrders.end(), order));
-                i--; // since we're updating the vector mid-running.
+                Volunteer *volunteer = assignCollector(order, freeCollectors.back());
+                freeCollectors.back() = volunteer; // It may have been cloned, see ownVolunteer
+                if (!volunteer->isLoading()) { // Collectors with room left keep picking orders for the same batch
+                    freeCollectors.pop_back();
+                }
+                served[position] = true;
             }
         }
         else if(orderStatus == OrderStatus::COLLECTING) {
-            if (!freeDrivers.empty()) {
+            if (!freeDrivers.empty() && greedyDrivers) {
                 Volunteer *driver = nullptr;
                 for(unsigned long j = 0; j < freeDrivers.size() && driver == nullptr; j++) {
                     if(freeDrivers[j]->canTakeOrder(*order)) {
@@ -544,39 +918,58 @@ void WareHouse::step() {
                     }
                 }
                 if(driver) {
-                    order->setDriverId(driver->getId());
-                    driver->acceptOrder(*order);
-                    order->setStatus(OrderStatus::DELIVERING);
-                    inProcessOrders.push_back(order);
-                    freeDrivers.erase(find(freeDrivers.begin(), freeDrivers.end(), driver));
-
-                    pendingOrders.erase(find(pendingOrders.begin(), pendingOrders.end(), order));
-                    i--; // since we're updating the vector mid-running.
+                    vector<Volunteer*>::iterator listed = find(freeDrivers.begin(), freeDrivers.end(), driver);
+                    driver = assignDriver(order, driver);
+                    if (!driver->isLoading()) { // Drivers with room left keep loading orders for the same trip
+                        freeDrivers.erase(listed);
+                    } else {
+                        *listed = driver; // It may have been cloned, see ownVolunteer
+                    }
+                    served[position] = true;
                 }
             }
         } else { // That's redundant, but it's here just in case.
             order->setStatus(OrderStatus::COMPLETED);
-            pendingOrders.erase(find(pendingOrders.begin(), pendingOrders.end(), order));
-            i--; // since we're updating the vector mid-running.
+            if (tracking) {
+                orderIndex.changeStatus(*order, orderStatus);
+                history.record(order->getId(), stepCount + 1, OrderStatus::COMPLETED, NO_VOLUNTEER);
+            }
+            served[position] = true;
             completedOrders.push_back(order);
         }
     }
+    unsigned long kept = 0;
+    for (unsigned long i = 0; i < pendingOrders.size(); i++) {
+        if (!served[i]) pendingOrders[kept++] = pendingOrders[i];
+    }
+    pendingOrders.resize(kept);
+    if (dispatchPolicy == DispatchPolicy::Matching && !freeDrivers.empty()) {
+        matchDrivers(freeDrivers);
+    }
 
     for (unsigned long i = 0; i < volunteers.size(); i++) {
         Volunteer *volunteer = volunteers[i];
         int activeId = volunteer->getActiveOrderId();
         if(activeId != NO_ORDER) {
+            volunteer = ownVolunteer(volunteer);
             volunteer->step();
+            if (publishingViews) changedVolunteers.push_back(volunteer->getId());
+            for (int orderId : volunteer->getFinishedOrderIds()) {
+                advanceOrder(orderId);
+            }
             if(volunteer->getActiveOrderId() == NO_ORDER) {
-                advanceOrder(volunteer->getCompletedOrderId());
                 if(!volunteer->hasOrdersLeft()) {
-                    delete volunteer;
+                    Volunteer::release(volunteer);
                     volunteers[i] = nullptr; // just in case, it's redundant.
                 }
             }
         }
     }
     volunteers.erase(remove(volunteers.begin(), volunteers.end(), nullptr), volunteers.end());
+    stepCount++;
+    unjournaledSteps++;
+    if (tracer) tracer->flushIfFull();
+    if (publishingViews) publishReadView(false);
 }
 
 /**
@@ -584,19 +977,322 @@ void WareHouse::step() {
  * @param orderId the id of the order to advance.
  */
 void WareHouse::advanceOrder(int orderId) {
+    MemoryScope scope(memory);
     unsigned long size = inProcessOrders.size();
     for(unsigned long i = 0; i < size; i++) {
         Order *order = inProcessOrders[i];
         if(order->getId() == orderId) {
             OrderStatus orderStatus = order->getStatus();
+            // Volunteers finish at the end of the current step.
             if(orderStatus == OrderStatus::COLLECTING) {
                 pendingOrders.push_back(order);
+                if (tracer) tracer->record(stepCount + 1, orderId, TracePhase::AwaitingDriver, order->getCollectorId());
             } else if(orderStatus == OrderStatus::DELIVERING) {
                 order->setStatus(OrderStatus::COMPLETED);
+                if (tracking) {
+                    orderIndex.changeStatus(*order, orderStatus);
+                    history.record(orderId, stepCount + 1, OrderStatus::COMPLETED, order->getDriverId());
+                }
+                order->setCompletedStep(stepCount + 1);
                 completedOrders.push_back(order);
+                if (tracer) tracer->record(stepCount + 1, orderId, TracePhase::Completed, order->getDriverId());
             }
+            if (publishingViews) changedOrders.push_back(order);
             inProcessOrders.erase(find(inProcessOrders.begin(), inProcessOrders.end(), order));
             return;
         }
     }
 }
+
+/**
+ * @returns amount of steps performed so far.
+ */
+int WareHouse::getStepCount() const {
+    return stepCount;
+}
+
+/**
+ * Enables tracing of the orders' lifecycle.
+ * @param tracer the tracer to record to, not owned by the warehouse, nullptr disables tracing.
+ */
+void WareHouse::setTracer(OrderTracer *tracer) {
+    this->tracer = tracer;
+}
+
+/**
+ * @param journal the journal the performed commands are appended to, nullptr disables journaling. Not owned.
+ */
+void WareHouse::setJournal(Journal *journal) {
+    this->journal = journal;
+}
+
+/**
+ * Submits an order from any thread, it's placed at the beginning of the next step.
+ * @param customerId the customer placing the order.
+ */
+void WareHouse::submitOrder(int customerId) {
+    submittedOrders.push(customerId);
+}
+
+/**
+ * Places the orders submitted through submitOrder as if each was an order command, in submission order,
+ * so order ids are deterministic for a given submission order. Called from the simulation thread only.
+ * Each order is journaled as an order command, before the command whose step drained it. A step command that
+ * drains orders after its first step is journaled as separate step commands around them, so the replay places
+ * them at the same step; a generate command is journaled the same way, with the orders it placed as order commands.
+ * @returns amount of drained requests (including the rejected ones).
+ */
+int WareHouse::drainSubmittedOrders() {
+    MemoryScope scope(memory);
+    int customerId;
+    int drained = 0;
+    while (submittedOrders.pop(customerId)) {
+        if (journal && isOpen && stepCommand && (unjournaledSteps > 0 || !unjournaledOrders.empty())) {
+            journalSteps();
+            stepsSplit = true;
+        }
+        // Rejects customers that don't exist or reached their max orders
+        performAndJournal(new AddOrder(customerId), "order " + to_string(customerId));
+        drained++;
+    }
+    return drained;
+}
+
+/**
+ * Starts publishing a read view after every step (and after restore), and publishes the first one right away.
+ */
+void WareHouse::enableReadViews() {
+    publishingViews = true;
+    publishReadView(true);
+}
+
+/**
+ * Publishes a read view with what changed since the last one (if anything did), so the view also reflects the
+ * commands performed since the last step. Does nothing if read views aren't enabled.
+ */
+void WareHouse::refreshReadView() {
+    if (!publishingViews || (changedOrders.empty() && changedCustomers.empty() && changedVolunteers.empty())) return;
+    publishReadView(false);
+}
+
+/**
+ * Safe to call from any thread while the simulation runs.
+ * @returns the latest published view, nullptr if read views aren't enabled.
+ */
+shared_ptr<const ReadView> WareHouse::getReadView() const {
+    return std::atomic_load(&readView);
+}
+
+/**
+ * Publishes a new read view with the changes since the previous one.
+ * @param rebuild if true the view is built from scratch, used when all the state was replaced.
+ */
+void WareHouse::publishReadView(bool rebuild) {
+    shared_ptr<const ReadView> previous = std::atomic_load(&readView);
+    long version = previous ? previous->getVersion() + 1 : 1;
+    if (rebuild) {
+        previous = shared_ptr<const ReadView>();
+        changedOrders.assign(pendingOrders.begin(), pendingOrders.end());
+        changedOrders.insert(changedOrders.end(), inProcessOrders.begin(), inProcessOrders.end());
+        changedOrders.insert(changedOrders.end(), completedOrders.begin(), completedOrders.end());
+        changedCustomers.clear();
+        for (int id = 0; id < customers.size(); id++) changedCustomers.push_back(id);
+    }
+    MemoryScope views(MemoryContext::unattributed()); // Views outlive the warehouse in their readers' hands
+    shared_ptr<const ReadView> next = ReadView::publish(previous, version, stepCount, changedOrders,
+                                                        customers, changedCustomers, volunteers, changedVolunteers);
+    std::atomic_store(&readView, next);
+    changedOrders.clear();
+    changedCustomers.clear();
+    changedVolunteers.clear();
+}
+
+/**
+ * Selects how free drivers are assigned to orders awaiting a driver.
+ */
+void WareHouse::setDispatchPolicy(DispatchPolicy policy) {
+    dispatchPolicy = policy;
+}
+
+DispatchPolicy WareHouse::getDispatchPolicy() const {
+    return dispatchPolicy;
+}
+
+/**
+ * Reseeds the service times of all the volunteers, the same seed always gives the same service times.
+ */
+void WareHouse::setSeed(unsigned long long seed) {
+    this->seed = seed;
+    for (Volunteer *volunteer : volunteers) {
+        ownVolunteer(volunteer)->setServiceSeed(seed);
+    }
+}
+
+unsigned long long WareHouse::getSeed() const {
+    return seed;
+}
+
+/**
+ * Hands a pending order to a free collector.
+ * @note The caller removes the order from pendingOrders.
+ * @returns the collector, a clone of it if it was shared (see ownVolunteer).
+ */
+Volunteer *WareHouse::assignCollector(Order *order, Volunteer *collector) {
+    collector = ownVolunteer(collector);
+    order->setCollectorId(collector->getId());
+    collector->acceptOrder(*order);
+    if (publishingViews) changedVolunteers.push_back(collector->getId());
+    order->setStatus(OrderStatus::COLLECTING);
+    if (tracking) {
+        orderIndex.assign(*order, collector->getId());
+        orderIndex.changeStatus(*order, OrderStatus::PENDING);
+        history.record(order->getId(), stepCount + 1, OrderStatus::COLLECTING, collector->getId());
+    }
+    inProcessOrders.push_back(order);
+    if (tracer) tracer->record(stepCount, order->getId(), TracePhase::Collecting, collector->getId());
+    if (publishingViews) changedOrders.push_back(order);
+    return collector;
+}
+
+/**
+ * Hands an order awaiting a driver to a free driver.
+ * @note The caller removes the order from pendingOrders.
+ * @returns the driver, a clone of it if it was shared (see ownVolunteer).
+ */
+Volunteer *WareHouse::assignDriver(Order *order, Volunteer *driver) {
+    driver = ownVolunteer(driver);
+    order->setDriverId(driver->getId());
+    driver->acceptOrder(*order);
+    if (publishingViews) changedVolunteers.push_back(driver->getId());
+    order->setStatus(OrderStatus::DELIVERING);
+    if (tracking) {
+        orderIndex.assign(*order, driver->getId());
+        orderIndex.changeStatus(*order, OrderStatus::COLLECTING);
+        history.record(order->getId(), stepCount + 1, OrderStatus::DELIVERING, driver->getId());
+    }
+    inProcessOrders.push_back(order);
+    if (tracer) tracer->record(stepCount, order->getId(), TracePhase::Delivering, driver->getId());
+    if (publishingViews) changedOrders.push_back(order);
+    return driver;
+}
+
+/**
+ * DispatchPolicy::Matching - assigns the free drivers to the orders awaiting a driver using DriverMatcher.
+ * Orders are matched in windows of the oldest ones (as many as there are free drivers), so the oldest orders
+ * are never starved by newer ones, and within a window long orders get the long range drivers.
+ * @param freeDrivers the free drivers, the assigned ones are removed.
+ */
+void WareHouse::matchDrivers(vector<Volunteer*> &freeDrivers) {
+    vector<Order*> awaiting;
+    for (Order *order : pendingOrders) {
+        if (order->getStatus() == OrderStatus::COLLECTING) awaiting.push_back(order);
+    }
+
+    // Group the drivers into classes of interchangeable drivers, in their original order.
+    // A driver carrying several orders per trip is counted as that many seats of its class.
+    vector<DriverClass> classes;
+    vector<vector<Volunteer*>> classDrivers;
+    vector<int> classCapacity;
+    unsigned long freeCount = 0;
+    for (Volunteer *volunteer : freeDrivers) {
+        DriverVolunteer *driver = static_cast<DriverVolunteer*>(volunteer); // visit() only lists drivers there
+        unsigned long c = 0;
+        while (c < classes.size() && (classes[c].maxDistance != driver->getMaxDistance() ||
+                                      classes[c].distancePerStep != driver->getDistancePerStep() ||
+                                      classCapacity[c] != driver->getCapacity())) c++;
+        if (c == classes.size()) {
+            classes.push_back({driver->getMaxDistance(), driver->getDistancePerStep(), 0});
+            classDrivers.push_back(vector<Volunteer*>());
+            classCapacity.push_back(std::max(1, driver->getCapacity()));
+        }
+        classes[c].count += classCapacity[c];
+        freeCount += classCapacity[c];
+        classDrivers[c].push_back(volunteer);
+    }
+    vector<unsigned long> classNext(classes.size(), 0); // The class's driver that gets its next order
+    vector<int> seatsTaken(classes.size(), 0); // Seats of that driver used so far
+
+    // Hands the order to the class's next driver with a seat left. A seat is only used once the driver takes the
+    // order: a driver that turns it down (a limited driver with fewer orders left than seats) gives up its
+    // remaining seats and the class's next driver is tried.
+    auto seat = [&](int c, Order *order) -> bool {
+        while (classNext[c] < classDrivers[c].size()) {
+            Volunteer *driver = classDrivers[c][classNext[c]];
+            bool taken = driver->canTakeOrder(*order);
+            if (taken) {
+                Volunteer *assigned = assignDriver(order, driver);
+                if (assigned != driver) { // Cloned, see ownVolunteer
+                    classDrivers[c][classNext[c]] = assigned;
+                    std::replace(freeDrivers.begin(), freeDrivers.end(), driver, assigned);
+                }
+            }
+            int used = taken ? 1 : classCapacity[c] - seatsTaken[c];
+            classes[c].count -= used;
+            freeCount -= used;
+            seatsTaken[c] += used;
+            if (seatsTaken[c] == classCapacity[c]) {
+                classNext[c]++;
+                seatsTaken[c] = 0;
+            }
+            if (taken) return true;
+        }
+        return false;
+    };
+
+    while (!awaiting.empty() && freeCount > 0) {
+        unsigned long end = std::min(awaiting.size(), freeCount);
+        vector<int> distances;
+        for (unsigned long i = 0; i < end; i++) distances.push_back(awaiting[i]->getDistance());
+        vector<int> assignment = DriverMatcher::match(distances, classes);
+        // Orders whose class ran out of seats go first in the next window, a turned down seat is never counted
+        // again so every window makes progress.
+        vector<Order*> left;
+        for (unsigned long i = 0; i < end; i++) {
+            if (assignment[i] != -1 && !seat(assignment[i], awaiting[i])) left.push_back(awaiting[i]);
+        }
+        left.insert(left.end(), awaiting.begin() + end, awaiting.end());
+        awaiting.swap(left);
+    }
+
+    pendingOrders.erase(remove_if(pendingOrders.begin(), pendingOrders.end(), [](const Order *order) {
+        return order->getStatus() == OrderStatus::DELIVERING;
+    }), pendingOrders.end());
+    freeDrivers.erase(remove_if(freeDrivers.begin(), freeDrivers.end(), [](const Volunteer *driver) {
+        return driver->isBusy();
+    }), freeDrivers.end());
+}
+
+/**
+ * Selects the order in which pending orders are served, the default is FifoScheduler.
+ * @param scheduler a newly allocated scheduler, the warehouse takes ownership.
+ */
+void WareHouse::setScheduler(Scheduler *scheduler) {
+    delete this->scheduler;
+    this->scheduler = scheduler;
+}
+
+const Scheduler &WareHouse::getScheduler() const {
+    return *scheduler;
+}
+
+/**
+ * @returns the runner of the warehouse's what-if scenarios, its workers are started by the first call.
+ */
+ScenarioRunner &WareHouse::getScenarioRunner() {
+    if (scenarioRunner == nullptr) scenarioRunner = new ScenarioRunner();
+    return *scenarioRunner;
+}
+
+/**
+ * @param type the customers' type.
+ * @returns the latencies (in steps, from placement to completion) of the completed orders of that customer type.
+ */
+vector<int> WareHouse::getLatencies(CustomerType type) const {
+    vector<int> latencies;
+    for (const Order *order : completedOrders) {
+        if (customers[order->getCustomerId()].getType() == type) { // Customer ids are their indices
+            latencies.push_back(order->getLatency());
+        }
+    }
+    return latencies;
+}
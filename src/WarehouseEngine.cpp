@@ -0,0 +1,246 @@
+#include "../include/WarehouseEngine.h"
+#include "../include/Volunteer.h"
+
+OrderInfo::OrderInfo() :
+    id(-1),
+    customerId(-1),
+    distance(0),
+    status(OrderStatus::PENDING),
+    collectorId(NO_VOLUNTEER),
+    driverId(NO_VOLUNTEER),
+    createdStep(NO_STEP),
+    completedStep(NO_STEP)
+{ }
+
+CustomerInfo::CustomerInfo() :
+    id(-1),
+    name(),
+    type(CustomerType::Soldier),
+    distance(0),
+    maxOrders(0),
+    orderIds()
+{ }
+
+VolunteerInfo::VolunteerInfo() :
+    id(-1),
+    name(),
+    busy(false),
+    hasOrdersLeft(false),
+    activeOrderId(NO_ORDER),
+    completedOrderId(NO_ORDER)
+{ }
+
+// ####################################################################################### //
+//                                    WarehouseSnapshot                                    //
+// ####################################################################################### //
+
+WarehouseSnapshot::WarehouseSnapshot() : state() { }
+
+WarehouseSnapshot::WarehouseSnapshot(const shared_ptr<const WareHouse> &state) : state(state) { }
+
+bool WarehouseSnapshot::empty() const {
+    return state == nullptr;
+}
+
+/**
+ * @returns the steps performed when the snapshot was taken, 0 for an empty snapshot.
+ */
+int WarehouseSnapshot::getStepCount() const {
+    return state ? state->getStepCount() : 0;
+}
+
+/**
+ * @returns the orders placed when the snapshot was taken, 0 for an empty snapshot.
+ */
+int WarehouseSnapshot::getOrderCount() const {
+    return state ? state->getOrderCount() : 0;
+}
+
+// ####################################################################################### //
+//                                     WarehouseEngine                                     //
+// ####################################################################################### //
+
+WarehouseEngine::WarehouseEngine() : wareHouse() {
+    wareHouse.open();
+}
+
+/**
+ * @param configFilePath read line by line as the warehouse binary does, lines it rejects are printed.
+ */
+WarehouseEngine::WarehouseEngine(const string &configFilePath) : wareHouse(configFilePath) { }
+
+/**
+ * Adds a customer, as the customer command does.
+ * @returns the new customer's id, -1 if the distance or max orders is negative.
+ */
+int WarehouseEngine::addCustomer(const string &name, CustomerType type, int distance, int maxOrders) {
+    if (distance < 0 || maxOrders < 0) return -1; // Rejected by the customer command too
+    return wareHouse.addCustomer(type == CustomerType::Soldier ? 0 : 1, name, distance, maxOrders);
+}
+
+/**
+ * @param maxOrders NOT_LIMITED for a collector without an order limit.
+ * @returns the new collector's id, -1 if the limit or the options are invalid.
+ */
+int WarehouseEngine::addCollector(const string &name, int coolDown, int maxOrders, const VolunteerOptions &options) {
+    AddVolunteer action(wareHouse.getNames()->intern(name), coolDown, maxOrders, options);
+    return addVolunteer(action);
+}
+
+/**
+ * @param maxOrders NOT_LIMITED for a driver without an order limit.
+ * @returns the new driver's id, -1 if the limit or the options are invalid.
+ */
+int WarehouseEngine::addDriver(const string &name, int maxDistance, int distancePerStep, int maxOrders,
+                               const VolunteerOptions &options) {
+    AddVolunteer action(wareHouse.getNames()->intern(name), maxDistance, distancePerStep, maxOrders, options);
+    return addVolunteer(action);
+}
+
+/**
+ * Performs the action without logging it, as the config file does.
+ * @returns the added volunteer's id, -1 if the action added none.
+ */
+int WarehouseEngine::addVolunteer(AddVolunteer &action) {
+    int id = wareHouse.getVolunteerCount();
+    action.act(wareHouse);
+    return wareHouse.getVolunteerCount() > id ? id : -1;
+}
+
+/**
+ * Places an order for the customer, as the order command does.
+ * @returns the new order's id, -1 if the customer doesn't exist or reached its max orders.
+ */
+int WarehouseEngine::addOrder(int customerId) {
+    int id = wareHouse.getOrderCount();
+    return wareHouse.placeOrder(customerId) ? id : -1;
+}
+
+/**
+ * Submits an order from any thread, see WareHouse::submitOrder. The submitted orders are placed at the start of the
+ * next step in submission order, and like submitted order commands they're logged.
+ */
+void WarehouseEngine::submitOrder(int customerId) {
+    wareHouse.submitOrder(customerId);
+}
+
+void WarehouseEngine::step(int steps) {
+    for (int i = 0; i < steps; i++) {
+        wareHouse.step();
+    }
+}
+
+int WarehouseEngine::getStepCount() const {
+    return wareHouse.getStepCount();
+}
+
+int WarehouseEngine::getCustomerCount() const {
+    return wareHouse.getCustomerCount();
+}
+
+int WarehouseEngine::getVolunteerCount() const {
+    return wareHouse.getVolunteerCount();
+}
+
+int WarehouseEngine::getOrderCount() const {
+    return wareHouse.getOrderCount();
+}
+
+/**
+ * @param info set to the order, left as is if it doesn't exist.
+ * @returns false if the order doesn't exist.
+ */
+bool WarehouseEngine::getOrder(int orderId, OrderInfo &info) const {
+    const Order *order = wareHouse.findOrder(orderId);
+    if (order == nullptr) return false;
+    info.id = order->getId();
+    info.customerId = order->getCustomerId();
+    info.distance = order->getDistance();
+    info.status = order->getStatus();
+    info.collectorId = order->getCollectorId();
+    info.driverId = order->getDriverId();
+    info.createdStep = order->getCreatedStep();
+    info.completedStep = order->getCompletedStep();
+    return true;
+}
+
+/**
+ * @param info set to the customer, left as is if it doesn't exist.
+ * @returns false if the customer doesn't exist.
+ */
+bool WarehouseEngine::getCustomer(int customerId, CustomerInfo &info) const {
+    const Customer *customer = wareHouse.findCustomer(customerId);
+    if (customer == nullptr) return false;
+    OrderIdRange orderIds = wareHouse.getCustomerOrderIds(customerId);
+    info.id = customer->getId();
+    info.name = wareHouse.getNames()->get(customer->getNameId());
+    info.type = customer->getType();
+    info.distance = customer->getCustomerDistance();
+    info.maxOrders = customer->getMaxOrders();
+    info.orderIds.assign(orderIds.begin(), orderIds.end());
+    return true;
+}
+
+/**
+ * @param info set to the volunteer, left as is if it doesn't exist.
+ * @returns false if the volunteer doesn't exist.
+ */
+bool WarehouseEngine::getVolunteer(int volunteerId, VolunteerInfo &info) const {
+    const Volunteer *volunteer = wareHouse.findVolunteer(volunteerId);
+    if (volunteer == nullptr) return false;
+    info.id = volunteer->getId();
+    info.name = wareHouse.getNames()->get(volunteer->getNameId());
+    info.busy = volunteer->isBusy();
+    info.hasOrdersLeft = volunteer->hasOrdersLeft();
+    info.activeOrderId = volunteer->getActiveOrderId();
+    info.completedOrderId = volunteer->getCompletedOrderId();
+    return true;
+}
+
+/**
+ * Starts publishing a read view after every step, see WareHouse::enableReadViews. The status queries of the views
+ * (ReadView::orderStatus, customerStatus and volunteerStatus) can then be answered on other threads while this one
+ * steps.
+ */
+void WarehouseEngine::enableReadViews() {
+    wareHouse.enableReadViews();
+}
+
+/**
+ * Publishes a read view with the customers, volunteers and orders added since the last step.
+ */
+void WarehouseEngine::refreshReadView() {
+    wareHouse.refreshReadView();
+}
+
+/**
+ * Safe to call from any thread.
+ * @returns the latest published view, nullptr if read views aren't enabled.
+ */
+shared_ptr<const ReadView> WarehouseEngine::getReadView() const {
+    return wareHouse.getReadView();
+}
+
+/**
+ * Copies the warehouse, as the backup command does but without replacing the global backup.
+ */
+WarehouseSnapshot WarehouseEngine::snapshot() const {
+    return WarehouseSnapshot(std::make_shared<const WareHouse>(wareHouse));
+}
+
+/**
+ * Replaces the warehouse with a copy of the snapshot's, the snapshot can be restored again.
+ * @returns false if the snapshot is empty, the warehouse is then unchanged.
+ */
+bool WarehouseEngine::restore(const WarehouseSnapshot &snapshot) {
+    if (snapshot.empty()) return false;
+    wareHouse = *snapshot.state;
+    return true;
+}
+
+/**
+ * @returns the engine's warehouse, for what the typed API doesn't cover.
+ */
+WareHouse &WarehouseEngine::getWareHouse() {
+    return wareHouse;
+}
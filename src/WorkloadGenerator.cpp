@@ -0,0 +1,205 @@
+#include "../include/WorkloadGenerator.h"
+
+#include <cmath>
+#include <algorithm>
+
+// A handful of names, real workloads share names between many customers/volunteers.
+static const char *const NAMES[] = {
+    "Maya", "David", "Ben", "Rina", "Noam", "Ibrahim", "Ron", "Din", "Tamar", "Omer", "Yael", "Amit"
+};
+static const int NAMES_COUNT = sizeof(NAMES) / sizeof(NAMES[0]);
+
+/**
+ * Builds a spec whose volunteer roster roughly keeps up with the arrival rate,
+ * so the backlog stays bounded and the scale is driven by the amount of orders.
+ * @param orders amount of orders the command script places.
+ * @param seed the generator's seed.
+ */
+WorkloadSpec WorkloadSpec::forOrders(long orders, unsigned long long seed) {
+    WorkloadSpec spec;
+    spec.seed = seed;
+    spec.orders = orders;
+    spec.ordersPerStep = 100;
+    spec.customers = (int) std::max(10L, orders / 10);
+    // Collectors take 2 steps on average and drivers around 3, give them some slack.
+    spec.collectors = spec.ordersPerStep * 5 / 2;
+    spec.drivers = spec.ordersPerStep * 4;
+    spec.driverCapacity = 1;
+    spec.collectorBatch = 1;
+    spec.maxDistance = 10;
+    spec.burstPeriod = 10;
+    spec.drainSteps = 50;
+    spec.pattern = ArrivalPattern::Uniform;
+    spec.dispatch = DispatchPolicy::Greedy;
+    spec.service = ServiceDistribution::Fixed;
+    return spec;
+}
+
+/**
+ * @param spec the workload to generate.
+ */
+WorkloadGenerator::WorkloadGenerator(const WorkloadSpec &spec) :
+    spec(spec),
+    state(spec.seed),
+    ordersLeft(),
+    maxOrdersPerCustomer((int) (spec.orders / std::max(1, spec.customers)) * 2 + 1)
+{ }
+
+/**
+ * @returns the generated workload description.
+ */
+const WorkloadSpec &WorkloadGenerator::getSpec() const {
+    return spec;
+}
+
+/**
+ * Restarts the random sequence, every output section has its own salt so changing the amount of
+ * orders doesn't change the generated config.
+ */
+void WorkloadGenerator::reseed(unsigned long long salt) {
+    state = spec.seed ^ (salt * 0x9E3779B97F4A7C15ULL);
+}
+
+/**
+ * splitmix64 - tiny, fast and fully specified.
+ */
+unsigned long long WorkloadGenerator::next() {
+    unsigned long long z = (state += 0x9E3779B97F4A7C15ULL);
+    z = (z ^ (z >> 30)) * 0xBF58476D1CE4E5B9ULL;
+    z = (z ^ (z >> 27)) * 0x94D049BB133111EBULL;
+    return z ^ (z >> 31);
+}
+
+int WorkloadGenerator::nextInt(int low, int high) {
+    return low + (int) (next() % (unsigned long long) (high - low + 1));
+}
+
+double WorkloadGenerator::nextDouble() {
+    return (double) (next() >> 11) * (1.0 / 9007199254740992.0);
+}
+
+/**
+ * Writes the customers and volunteers in the config file grammar.
+ * @param out stream to write the config to.
+ */
+void WorkloadGenerator::writeConfig(std::ostream &out) {
+    reseed(1);
+    out << "# Generated workload, seed " << spec.seed << "\n";
+    out << "# Customers\n";
+    ordersLeft.assign(spec.customers, maxOrdersPerCustomer);
+    for (int i = 0; i < spec.customers; i++) {
+        out << "customer " << NAMES[nextInt(0, NAMES_COUNT - 1)]
+            << (nextInt(0, 9) < 3 ? " soldier " : " civilian ")
+            << nextInt(1, spec.maxDistance) << " " << maxOrdersPerCustomer << "\n";
+    }
+    out << "# Volunteers\n";
+    for (int i = 0; i < spec.collectors; i++) {
+        out << "volunteer " << NAMES[nextInt(0, NAMES_COUNT - 1)] << " collector " << nextInt(1, 3);
+        if (spec.collectorBatch > 1) out << " batch=" << spec.collectorBatch;
+        writeService(out);
+        out << "\n";
+    }
+    // Half of the drivers can reach every customer, the rest only the nearer ones.
+    for (int i = 0; i < spec.drivers; i++) {
+        int range = i % 2 == 0 ? spec.maxDistance : nextInt((spec.maxDistance + 1) / 2, spec.maxDistance);
+        out << "volunteer " << NAMES[nextInt(0, NAMES_COUNT - 1)] << " driver " << range << " " << nextInt(2, 5);
+        if (spec.driverCapacity > 1) out << " capacity=" << spec.driverCapacity;
+        writeService(out);
+        out << "\n";
+    }
+    if (spec.service != ServiceDistribution::Fixed) {
+        out << "seed " << spec.seed << "\n";
+    }
+    if (spec.dispatch == DispatchPolicy::Matching) {
+        out << "dispatch matching\n";
+    }
+}
+
+/**
+ * Writes the service time option of a volunteer line, if the service times aren't fixed.
+ */
+void WorkloadGenerator::writeService(std::ostream &out) const {
+    if (spec.service != ServiceDistribution::Fixed) {
+        out << " service=" << ServiceTime::distributionName(spec.service);
+    }
+}
+
+/**
+ * @returns the amount of orders arriving at the given step according to the arrival pattern.
+ */
+long WorkloadGenerator::arrivalsAt(long step) {
+    switch (spec.pattern) {
+        case ArrivalPattern::Burst:
+            return step % spec.burstPeriod == 0 ? (long) spec.ordersPerStep * spec.burstPeriod : 0;
+        case ArrivalPattern::Poisson: {
+            double lambda = spec.ordersPerStep;
+            if (lambda > 30) { // Normal approximation, Knuth's method underflows for large rates.
+                double u1 = std::max(nextDouble(), 1e-12), u2 = nextDouble();
+                double normal = std::sqrt(-2.0 * std::log(u1)) * std::cos(6.283185307179586 * u2);
+                return std::max(0L, std::lround(lambda + normal * std::sqrt(lambda)));
+            }
+            double limit = std::exp(-lambda), product = nextDouble();
+            long count = 0;
+            while (product > limit) {
+                product *= nextDouble();
+                count++;
+            }
+            return count;
+        }
+        default:
+            return spec.ordersPerStep;
+    }
+}
+
+/**
+ * @returns a random customer that can still place an order.
+ */
+int WorkloadGenerator::pickCustomer() {
+    int id = nextInt(0, spec.customers - 1);
+    while (ordersLeft[id] == 0) { // Capacity is twice the amount of orders, this ends quickly.
+        id = (id + 1) % spec.customers;
+    }
+    ordersLeft[id]--;
+    return id;
+}
+
+/**
+ * Writes the session commands: the orders interleaved with single steps according to the arrival
+ * pattern, followed by a drain step. Every order line is valid for the config written by writeConfig.
+ * @param out stream to write the commands to.
+ */
+void WorkloadGenerator::writeCommands(std::ostream &out) {
+    reseed(2);
+    ordersLeft.assign(spec.customers, maxOrdersPerCustomer);
+    long placed = 0;
+    for (long step = 0; placed < spec.orders; step++) {
+        long arrivals = std::min(arrivalsAt(step), spec.orders - placed);
+        for (long i = 0; i < arrivals; i++) {
+            out << "order " << pickCustomer() << "\n";
+        }
+        placed += arrivals;
+        out << "step 1\n";
+    }
+    out << "step " << spec.drainSteps << "\n";
+}
+
+/**
+ * @param name one of uniform, burst, poisson.
+ * @param pattern set to the matching pattern.
+ * @returns false if the name is unknown.
+ */
+bool WorkloadGenerator::parsePattern(const string &name, ArrivalPattern &pattern) {
+    if (name == "uniform") pattern = ArrivalPattern::Uniform;
+    else if (name == "burst") pattern = ArrivalPattern::Burst;
+    else if (name == "poisson") pattern = ArrivalPattern::Poisson;
+    else return false;
+    return true;
+}
+
+string WorkloadGenerator::patternName(ArrivalPattern pattern) {
+    switch (pattern) {
+        case ArrivalPattern::Burst: return "burst";
+        case ArrivalPattern::Poisson: return "poisson";
+        default: return "uniform";
+    }
+}
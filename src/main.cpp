@@ -1,21 +1,93 @@
 #include "../include/WareHouse.h"
+#include "../include/SocketServer.h"
+#include "../include/Action.h"
 #include <iostream>
 
 using namespace std;
 
-WareHouse* backup = nullptr;
+#define USAGE "usage: warehouse <config_path> [--trace <trace_file>] [--listen <socket_path>] [--journal <journal_file>] [--record <recording_file>]"
 
 int main(int argc, char** argv){
-    if(argc!=2){
-        std::cout << "usage: warehouse <config_path>" << std::endl;
+    if(argc<2 || argc%2!=0){
+        std::cout << USAGE << std::endl;
         return 0;
     }
     string configurationFile = argv[1];
+    string tracePath;
+    string socketPath;
+    string journalPath;
+    string recordingPath;
+    for(int i = 2; i < argc; i += 2){
+        string option = argv[i];
+        if(option=="--trace"){
+            tracePath = argv[i+1];
+        } else if(option=="--listen"){
+            socketPath = argv[i+1];
+        } else if(option=="--journal"){
+            journalPath = argv[i+1];
+        } else if(option=="--record"){
+            recordingPath = argv[i+1];
+        } else {
+            std::cout << USAGE << std::endl;
+            return 0;
+        }
+    }
+    OrderTracer* tracer = tracePath.empty() ? nullptr : new OrderTracer(tracePath);
+    if(tracer!=nullptr && !tracer->isOpen()){
+        std::cout << "Failed to open the trace file " << tracePath << std::endl;
+        delete tracer;
+        return 1;
+    }
     WareHouse wareHouse(configurationFile);
-    wareHouse.start();
+    Journal* journal = nullptr;
+    if(!journalPath.empty()){
+        long replayed = Journal::replay(journalPath, wareHouse); // Before tracing, the trace covers this session
+        if(replayed < 0){
+            delete tracer;
+            return 1;
+        }
+        if(replayed > 0){
+            std::cout << "Replayed " << replayed << " commands from " << journalPath << std::endl;
+        }
+        journal = new Journal(journalPath);
+        if(!journal->isOpen()){
+            std::cout << "Failed to open the journal " << journalPath << std::endl;
+            delete journal;
+            delete tracer;
+            return 1;
+        }
+        wareHouse.setJournal(journal);
+    }
+    wareHouse.setTracer(tracer);
+    SessionRecorder* recorder = recordingPath.empty() ? nullptr : new SessionRecorder(recordingPath);
+    if(recorder!=nullptr && !recorder->isOpen()){
+        std::cout << "Failed to open the recording " << recordingPath << std::endl;
+        std::cout << USAGE << std::endl;
+        delete recorder;
+        delete journal;
+        delete tracer;
+        return 1;
+    }
+    bool served = true;
+    if(socketPath.empty()){
+        wareHouse.start(recorder);
+    } else {
+        wareHouse.enableReadViews(); // The server answers status queries from the views
+        SocketServer server(wareHouse, socketPath, recorder);
+        served = server.run(); // False if the socket couldn't be set up, the error is printed
+    }
+    delete recorder; // Writes the rest of the recording
     if(backup!=nullptr){
     	delete backup;
     	backup = nullptr;
     }
-    return 0;
+    if(tracer!=nullptr){
+        delete tracer; // Writes the rest of the trace
+        tracer = nullptr;
+    }
+    if(journal!=nullptr){
+        delete journal; // Waits for the rest of the journal to reach the disk
+        journal = nullptr;
+    }
+    return served ? 0 : 1;
 }
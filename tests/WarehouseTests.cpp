@@ -0,0 +1,315 @@
+#include "../include/WareHouse.h"
+#include "../include/WarehouseEngine.h"
+#include "../include/Dispatch.h"
+
+#include <iostream>
+#include <fstream>
+#include <sstream>
+#include <cstdio>
+#include <thread>
+
+using namespace std;
+
+#define CONFIG_PATH "warehouse_tests.config"
+#define JOURNAL_PATH "warehouse_tests.journal"
+#define SPILL_PATH "warehouse_tests.spill"
+#define PRODUCERS 4
+#define PRODUCER_ORDERS 2000
+
+static int failures = 0;
+
+#define CHECK(condition) check((condition), #condition, __FILE__, __LINE__)
+
+static void check(bool passed, const char *condition, const char *file, int line) {
+    if (passed) return;
+    std::cerr << file << ":" << line << ": check failed: " << condition << std::endl;
+    failures++;
+}
+
+/**
+ * Swallows everything the actions print.
+ */
+class NullBuffer : public std::streambuf {
+    protected:
+        int overflow(int c) override { return c; }
+        std::streamsize xsputn(const char *, std::streamsize n) override { return n; }
+};
+
+static void writeConfig() {
+    std::ofstream config(CONFIG_PATH);
+    config << "customer Maya soldier 4 6\n"
+              "customer David civilian 3 4\n"
+              "customer Ben civilian 7 8\n"
+              "customer Rina soldier 2 6\n"
+              "volunteer Noam collector 2\n"
+              "volunteer Ibrahim limited_collector 3 4\n"
+              "volunteer Ron driver 7 4\n"
+              "volunteer Din limited_driver 5 3 3\n";
+}
+
+/**
+ * @returns the steps, the customers and every order's state, equal for warehouses in the same state.
+ */
+static string stateOf(const WareHouse &wareHouse) {
+    std::ostringstream state;
+    state << wareHouse.getStepCount() << " " << wareHouse.getCustomerCount() << " " << wareHouse.getOrderCount();
+    for (int id = 0; id < wareHouse.getOrderCount(); id++) {
+        const Order *order = wareHouse.findOrder(id);
+        state << "|" << order->getCustomerId() << "," << (int) order->getStatus() << "," << order->getCollectorId()
+              << "," << order->getDriverId() << "," << order->getCreatedStep() << "," << order->getCompletedStep();
+    }
+    return state.str();
+}
+
+/**
+ * A journaled session, replayed from the journal into a warehouse made from the same config, ends up in the same
+ * state - including orders submitted right before a generate, which are drained in the middle of it.
+ */
+static void testJournalReplay() {
+    writeConfig();
+    std::remove(JOURNAL_PATH);
+    string journaled;
+    {
+        WareHouse wareHouse(CONFIG_PATH);
+        wareHouse.open();
+        Journal journal(JOURNAL_PATH);
+        wareHouse.setJournal(&journal);
+        wareHouse.execute("order 0");
+        wareHouse.execute("orders 1 2");
+        wareHouse.execute("step 2");
+        wareHouse.submitOrder(3);
+        wareHouse.submitOrder(2);
+        wareHouse.execute("step 3");
+        wareHouse.execute("customer Zed civilian 2 3");
+        wareHouse.submitOrder(4);
+        wareHouse.submitOrder(0);
+        wareHouse.execute("generate 6 rate=1.5 seed=7");
+        wareHouse.execute("orderStatus 1");
+        wareHouse.execute("step 4");
+        CHECK(journal.flush());
+        journaled = stateOf(wareHouse);
+        CHECK(wareHouse.getOrderCount() > 8); // The generate placed orders too
+    }
+    WareHouse replayed(CONFIG_PATH);
+    CHECK(Journal::replay(JOURNAL_PATH, replayed) > 0);
+    CHECK(stateOf(replayed) == journaled);
+    std::remove(JOURNAL_PATH);
+    std::remove(CONFIG_PATH);
+}
+
+/**
+ * An order's state at a past step is the state it had right before the next step was performed.
+ */
+static void testOrderHistory() {
+    WarehouseEngine engine;
+    WareHouse &wareHouse = engine.getWareHouse();
+    int customer = engine.addCustomer("dana", CustomerType::Soldier, 3, 5);
+    engine.addCollector("avi", 2);
+    engine.addDriver("noa", 5, 1);
+    engine.step(2);
+    int order = engine.addOrder(customer); // Placed after step 2
+    engine.step(8);
+
+    OrderInfo info;
+    CHECK(engine.getOrder(order, info));
+    CHECK(info.status == OrderStatus::COMPLETED);
+    Order past(order, customer, 0);
+    CHECK(!wareHouse.getOrderAt(order, 1, past)); // Not placed yet
+    CHECK(wareHouse.getOrderAt(order, 2, past) && past.getStatus() == OrderStatus::PENDING);
+    CHECK(wareHouse.getOrderAt(order, 3, past) && past.getStatus() == OrderStatus::COLLECTING);
+    CHECK(past.getCollectorId() == 0 && past.getDriverId() == NO_VOLUNTEER);
+    CHECK(wareHouse.getOrderAt(order, 6, past) && past.getStatus() == OrderStatus::DELIVERING);
+    CHECK(past.getDriverId() == 1);
+    CHECK(wareHouse.getOrderAt(order, info.completedStep - 1, past) && past.getStatus() == OrderStatus::DELIVERING);
+    CHECK(wareHouse.getOrderAt(order, info.completedStep, past) && past.getStatus() == OrderStatus::COMPLETED);
+    CHECK(wareHouse.getOrderAt(order, 100, past) && past.getStatus() == OrderStatus::COMPLETED);
+    CHECK(!wareHouse.getOrderAt(order + 1, 10, past));
+}
+
+/**
+ * @returns the log's entries from..from + count - 1, one line each.
+ */
+static vector<string> logLines(const WareHouse &wareHouse, long from, long count) {
+    std::ostringstream text;
+    wareHouse.getActions().print(from, count, text);
+    vector<string> lines;
+    std::istringstream input(text.str());
+    string line;
+    while (getline(input, line)) lines.push_back(line);
+    return lines;
+}
+
+/**
+ * A spilling log keeps printing any slice of its entries after a backup is restored, and the restored log goes on
+ * spilling.
+ */
+static void testLogSpill() {
+    writeConfig();
+    std::remove(SPILL_PATH);
+    {
+        WareHouse wareHouse(CONFIG_PATH);
+        CHECK(wareHouse.setLogRetention(LogRetention::Spill, 4, SPILL_PATH));
+        wareHouse.open();
+        vector<string> expected;
+        for (int i = 0; i < 10; i++) {
+            wareHouse.execute("orderStatus " + std::to_string(i));
+            expected.push_back("orderStatus " + std::to_string(i) + " ERROR");
+        }
+        wareHouse.execute("backup");
+        for (int i = 0; i < 3; i++) wareHouse.execute("step 1");
+        wareHouse.execute("restore");
+        expected.push_back("restore COMPLETED"); // The backup was taken before it was logged
+        CHECK(wareHouse.getActions().size() == 11);
+        CHECK(wareHouse.getStepCount() == 0);
+        for (int i = 0; i < 6; i++) {
+            wareHouse.execute("customerStatus " + std::to_string(i));
+            expected.push_back("customerStatus " + std::to_string(i) + (i < 4 ? " COMPLETED" : " ERROR"));
+        }
+        CHECK(logLines(wareHouse, 0, -1) == expected);
+        CHECK(logLines(wareHouse, 2, 3) == vector<string>(expected.begin() + 2, expected.begin() + 5));
+        CHECK(logLines(wareHouse, 9, 4) == vector<string>(expected.begin() + 9, expected.begin() + 13));
+        CHECK(logLines(wareHouse, 15, 10) == vector<string>(expected.begin() + 15, expected.end()));
+        if (backup != nullptr) {
+            delete backup;
+            backup = nullptr;
+        }
+    }
+    std::remove(SPILL_PATH);
+    std::remove(CONFIG_PATH);
+}
+
+/**
+ * @returns false if the table's order ids of a customer differ from the expected ones.
+ */
+static bool sameOrders(const CustomerTable &table, const vector<vector<int>> &expected) {
+    for (int id = 0; id < table.size(); id++) {
+        OrderIdRange orderIds = table.getOrdersIds(id);
+        if (vector<int>(orderIds.begin(), orderIds.end()) != expected[id]) return false;
+    }
+    return true;
+}
+
+/**
+ * Customers' order ids survive their regions growing, moving to the end of the array and being packed again.
+ */
+static void testCustomerTable() {
+    CustomerTable table;
+    vector<vector<int>> expected(20);
+    for (int id = 0; id < 20; id++) {
+        CHECK(table.add(0, CustomerType::Civilian, 1, id < 10 ? 64 : 3) == id);
+    }
+    int orderId = 0;
+    for (int round = 0; round < 64; round++) {
+        for (int id = 0; id < 20; id++) {
+            if (round % (1 + id % 3) != 0) continue; // Customers grow at different paces, regions keep moving
+            bool placed = table.addOrder(id, orderId);
+            CHECK(placed == ((int) expected[id].size() < table[id].getMaxOrders()));
+            if (placed) expected[id].push_back(orderId++);
+        }
+        if (round % 8 == 0) CHECK(sameOrders(table, expected));
+    }
+    CHECK(sameOrders(table, expected));
+    CHECK(expected[0].size() == 64 && expected[10].size() == 3);
+    CHECK(!table.addOrder(20, orderId) && !table.addOrder(-1, orderId));
+    CustomerTable copy(table);
+    CHECK(sameOrders(copy, expected));
+}
+
+/**
+ * The matching first assigns as many orders as it can, then picks the assignment with the fewest delivery steps.
+ */
+static void testDriverMatching() {
+    // A slow far reaching driver and a fast near one: the fast one takes the 5, the slow one the 2 (3 steps),
+    // sending the 8 out instead would take 9.
+    vector<DriverClass> classes = {{10, 1, 1}, {5, 5, 1}};
+    CHECK(DriverMatcher::match({8, 2, 5}, classes) == vector<int>({-1, 0, 1}));
+    // Orders of the same distance are served oldest first.
+    classes = {{5, 1, 2}};
+    CHECK(DriverMatcher::match({3, 3, 3}, classes) == vector<int>({0, 0, -1}));
+    // Nobody reaches the order.
+    classes = {{2, 1, 3}};
+    CHECK(DriverMatcher::match({4}, classes) == vector<int>({-1}));
+
+    // The same choice made by a warehouse: the slow driver is listed first, greedy would send it the oldest order.
+    WarehouseEngine engine;
+    engine.getWareHouse().setDispatchPolicy(DispatchPolicy::Matching);
+    int far = engine.addCustomer("far", CustomerType::Civilian, 5, 1);
+    int near = engine.addCustomer("near", CustomerType::Civilian, 2, 1);
+    engine.addCollector("c1", 1);
+    engine.addCollector("c2", 1);
+    int slow = engine.addDriver("slow", 10, 1);
+    int fast = engine.addDriver("fast", 5, 5);
+    int farOrder = engine.addOrder(far), nearOrder = engine.addOrder(near);
+    engine.step(2);
+    OrderInfo info;
+    CHECK(engine.getOrder(farOrder, info) && info.driverId == fast);
+    CHECK(engine.getOrder(nearOrder, info) && info.driverId == slow);
+}
+
+/**
+ * Orders submitted from several threads while the warehouse steps are each placed once, and each thread's orders
+ * get increasing ids in the order it submitted them. Producer p orders for the customers p, p + PRODUCERS, ...
+ */
+static void testSubmitOrder() {
+    WarehouseEngine engine;
+    for (int id = 0; id < 100; id++) engine.addCustomer("c" + std::to_string(id), CustomerType::Civilian, 1, 1000);
+    engine.addCollector("collector", 1);
+    engine.addDriver("driver", 1, 1);
+
+    vector<std::thread> producers;
+    for (int p = 0; p < PRODUCERS; p++) {
+        producers.push_back(std::thread([&engine, p]() {
+            for (int i = 0; i < PRODUCER_ORDERS; i++) engine.submitOrder(p + i * PRODUCERS % 100);
+        }));
+    }
+    while (engine.getOrderCount() < PRODUCERS * PRODUCER_ORDERS) engine.step();
+    for (std::thread &producer : producers) producer.join();
+    engine.step();
+
+    CHECK(engine.getOrderCount() == PRODUCERS * PRODUCER_ORDERS);
+    vector<int> submitted(PRODUCERS, 0);
+    OrderInfo info;
+    bool ordered = true;
+    for (int id = 0; id < engine.getOrderCount(); id++) {
+        engine.getOrder(id, info);
+        int p = info.customerId % PRODUCERS;
+        ordered = ordered && info.customerId == p + submitted[p] * PRODUCERS % 100;
+        submitted[p]++;
+    }
+    CHECK(ordered);
+    CHECK(submitted == vector<int>(PRODUCERS, PRODUCER_ORDERS));
+}
+
+struct Test {
+    const char *name;
+    void (*run)();
+};
+
+static const Test tests[] = {
+    {"journal_replay", testJournalReplay},
+    {"order_history", testOrderHistory},
+    {"log_spill", testLogSpill},
+    {"customer_table", testCustomerTable},
+    {"driver_matching", testDriverMatching},
+    {"submit_order", testSubmitOrder},
+};
+
+/**
+ * Runs the test named by the argument, or all of them.
+ * @returns 1 if a check failed or the test is unknown.
+ */
+int main(int argc, char **argv) {
+    NullBuffer sink;
+    std::streambuf *console = std::cout.rdbuf(&sink);
+    bool found = false;
+    for (const Test &test : tests) {
+        if (argc > 1 && string(argv[1]) != test.name) continue;
+        found = true;
+        int before = failures;
+        test.run();
+        std::cerr << test.name << ": " << (failures == before ? "passed" : "FAILED") << std::endl;
+    }
+    std::cout.rdbuf(console);
+    if (!found) std::cerr << "unknown test: " << argv[1] << std::endl;
+    return found && failures == 0 ? 0 : 1;
+}